@@ -0,0 +1,119 @@
+#include "Bitboard.hpp"
+
+namespace Bitboards {
+    std::array<SliderTable, 64> rook_tables;
+    std::array<SliderTable, 64> bishop_tables;
+    std::array<std::array<Bitboard, 64>, 64> between_squares;
+    std::array<std::array<Bitboard, 64>, 64> line_squares;
+}
+
+//Attack sets of all squares are stored back to back, sized by the number of relevant occupancies per square
+static std::array<Bitboard, 102400> rook_attacks;
+static std::array<Bitboard, 5248> bishop_attacks;
+
+Bitboard Bitboards::slidingAttacks(Square::Index index, Bitboard occupied, const int (&deltas)[4][2]) {
+    Bitboard attacks = 0;
+    for(const auto& delta : deltas) {
+        Bitboard ray = squareBit(index);
+        //Stop at the board edge (shift drops the bit) or after the first occupied square
+        while((ray = shift(ray, delta[0], delta[1]))) {
+            attacks |= ray;
+            if(ray & occupied) break;
+        }
+    }
+    return attacks;
+}
+
+#ifndef CHEESS_USE_PEXT
+//xorshift64*, deterministic so the magics found are the same on every run
+static std::uint64_t nextRandom(std::uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+#endif
+
+static void initSliderTables(std::array<Bitboards::SliderTable, 64>& tables, Bitboard* attacks, const int (&deltas)[4][2]) {
+    Bitboard occupancies[4096];
+    Bitboard references[4096];
+#ifndef CHEESS_USE_PEXT
+    unsigned epoch[4096] = {};
+    unsigned attempt = 0;
+    //Seeds per rank known to find all magics after few attempts
+    const std::uint64_t rank_seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+#endif
+
+    for(Square::Index index = 0; index < 64; index++) {
+        Bitboards::SliderTable& table = tables[index];
+
+        //Pieces on the board edge never block a ray, so they are left out of the relevant occupancy
+        Bitboard rank_edges = (Bitboards::rank_1 | Bitboards::rank_8) & ~(Bitboards::rank_1 << (8 * (index / 8)));
+        Bitboard file_edges = (Bitboards::file_a | Bitboards::file_h) & ~(Bitboards::file_a << (index % 8));
+        table.mask = Bitboards::slidingAttacks(index, 0, deltas) & ~(rank_edges | file_edges);
+        table.shift = 64 - Bitboards::popCount(table.mask);
+        table.magic = 0;
+        table.attacks = attacks;
+
+        //Enumerate all subsets of the mask (Carry-Rippler)
+        unsigned size = 0;
+        Bitboard subset = 0;
+        do {
+            occupancies[size] = subset;
+            references[size] = Bitboards::slidingAttacks(index, subset, deltas);
+            size++;
+            subset = (subset - table.mask) & table.mask;
+        } while(subset);
+
+#ifdef CHEESS_USE_PEXT
+        for(unsigned i = 0; i < size; i++) attacks[table.slot(occupancies[i])] = references[i];
+#else
+        //Try sparse random magics until one maps every occupancy without a destructive collision
+        std::uint64_t random_state = rank_seeds[index / 8];
+        bool found = false;
+        while(!found) {
+            do {
+                table.magic = nextRandom(random_state) & nextRandom(random_state) & nextRandom(random_state);
+            } while(Bitboards::popCount((table.mask * table.magic) >> 56) < 6);
+
+            attempt++;
+            found = true;
+            for(unsigned i = 0; i < size && found; i++) {
+                unsigned slot = table.slot(occupancies[i]);
+                if(epoch[slot] < attempt) {
+                    epoch[slot] = attempt;
+                    attacks[slot] = references[i];
+                } else if(attacks[slot] != references[i]) found = false;
+            }
+        }
+#endif
+        attacks += size;
+    }
+}
+
+static void initLineTables(const int (&deltas)[4][2]) {
+    for(Square::Index from = 0; from < 64; from++) {
+        Bitboard from_attacks = Bitboards::slidingAttacks(from, 0, deltas);
+        for(Square::Index to = 0; to < 64; to++) {
+            if(!Bitboards::isSet(from_attacks, to)) continue;
+            Bitboard to_attacks = Bitboards::slidingAttacks(to, 0, deltas);
+            Bitboards::line_squares[from][to] = (from_attacks & to_attacks) | Bitboards::squareBit(from) | Bitboards::squareBit(to);
+            Bitboards::between_squares[from][to] = Bitboards::slidingAttacks(from, Bitboards::squareBit(to), deltas) &
+                                                   Bitboards::slidingAttacks(to, Bitboards::squareBit(from), deltas);
+        }
+    }
+}
+
+static bool initAllSliderTables() {
+    initSliderTables(Bitboards::rook_tables, rook_attacks.data(), Bitboards::rook_deltas);
+    initSliderTables(Bitboards::bishop_tables, bishop_attacks.data(), Bitboards::bishop_deltas);
+    initLineTables(Bitboards::rook_deltas);
+    initLineTables(Bitboards::bishop_deltas);
+    return true;
+}
+
+void Bitboards::init() {
+    //Built on the first call, whatever the order in which the statics of other translation units are initialized
+    static const bool initialized = initAllSliderTables();
+    (void)initialized;
+}
@@ -0,0 +1,154 @@
+#ifndef CHESS_ENGINE_BITBOARD_HPP
+#define CHESS_ENGINE_BITBOARD_HPP
+
+#include "Square.hpp"
+#include "Piece.hpp"
+
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <cassert>
+
+#ifdef CHEESS_USE_PEXT
+#include <immintrin.h>
+#endif
+
+//One bit per square, bit i corresponds to Square index i (A1 = 0, H8 = 63)
+using Bitboard = std::uint64_t;
+
+namespace Bitboards {
+
+    constexpr Bitboard file_a = 0x0101010101010101ULL;
+    constexpr Bitboard file_h = 0x8080808080808080ULL;
+    constexpr Bitboard rank_1 = 0x00000000000000FFULL;
+    constexpr Bitboard rank_8 = 0xFF00000000000000ULL;
+
+    constexpr Bitboard squareBit(Square::Index index) {
+        return Bitboard(1) << index;
+    }
+
+    constexpr bool isSet(Bitboard bb, Square::Index index) {
+        return (bb >> index) & 1;
+    }
+
+    constexpr unsigned popCount(Bitboard bb) {
+        return std::popcount(bb);
+    }
+
+    //Index of the least significant set bit, bb must not be empty
+    constexpr Square::Index lsb(Bitboard bb) {
+        return std::countr_zero(bb);
+    }
+
+    //Returns the least significant set bit and clears it, bb must not be empty
+    constexpr Square::Index popLsb(Bitboard& bb) {
+        Square::Index index = lsb(bb);
+        bb &= bb - 1;
+        return index;
+    }
+
+    //Shifts that drop the bits wrapping around the board edge
+    constexpr Bitboard shift(Bitboard bb, int file_delta, int rank_delta) {
+        for(; file_delta > 0; file_delta--) bb = (bb & ~file_h) << 1;
+        for(; file_delta < 0; file_delta++) bb = (bb & ~file_a) >> 1;
+        if(rank_delta > 0) bb <<= 8 * rank_delta;
+        else if(rank_delta < 0) bb >>= 8 * -rank_delta;
+        return bb;
+    }
+
+    //Moves every bit one rank forward from the point of view of color
+    constexpr Bitboard pawnPush(PieceColor color, Bitboard bb) {
+        return color == PieceColor::White ? bb << 8 : bb >> 8;
+    }
+
+    constexpr std::array<Bitboard, 64> leaperAttacks(const int (&deltas)[8][2]) {
+        std::array<Bitboard, 64> table{};
+        for(Square::Index index = 0; index < 64; index++) {
+            for(const auto& delta : deltas) table[index] |= shift(squareBit(index), delta[0], delta[1]);
+        }
+        return table;
+    }
+
+    constexpr int knight_deltas[8][2] = {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}};
+    constexpr int king_deltas[8][2] = {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}};
+
+    inline constexpr std::array<Bitboard, 64> knight_attacks = leaperAttacks(knight_deltas);
+    inline constexpr std::array<Bitboard, 64> king_attacks = leaperAttacks(king_deltas);
+
+    inline constexpr std::array<std::array<Bitboard, 64>, 2> pawn_attacks = [] {
+        std::array<std::array<Bitboard, 64>, 2> table{};
+        for(Square::Index index = 0; index < 64; index++) {
+            table[0][index] = shift(squareBit(index), -1, 1) | shift(squareBit(index), 1, 1);
+            table[1][index] = shift(squareBit(index), -1, -1) | shift(squareBit(index), 1, -1);
+        }
+        return table;
+    }();
+
+    //Squares attacked by a pawn of the given color standing on index
+    constexpr Bitboard pawnAttacks(PieceColor color, Square::Index index) {
+        return pawn_attacks[color == PieceColor::White ? 0 : 1][index];
+    }
+
+    //Sliding piece lookup for one square: the relevant occupancy (mask) is mapped to a slot in attacks,
+    //either with a magic multiply or, when built with CHEESS_USE_PEXT, with the BMI2 PEXT instruction
+    struct SliderTable {
+        Bitboard mask;
+        Bitboard magic;
+        unsigned shift;
+        const Bitboard* attacks;
+
+        unsigned slot(Bitboard occupied) const {
+#ifdef CHEESS_USE_PEXT
+            return static_cast<unsigned>(_pext_u64(occupied, mask));
+#else
+            return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+#endif
+        }
+    };
+
+    //Builds the sliding piece and line tables, they are empty until then: main calls it before anything else
+    //Calling it again does nothing, so code running before main (static initializers) can call it first
+    void init();
+
+    //Filled in by init()
+    extern std::array<SliderTable, 64> rook_tables;
+    extern std::array<SliderTable, 64> bishop_tables;
+
+    inline Bitboard rookAttacks(Square::Index index, Bitboard occupied) {
+        const SliderTable& table = rook_tables[index];
+        assert(table.attacks != nullptr && "Bitboards::init() not called");
+        return table.attacks[table.slot(occupied)];
+    }
+
+    inline Bitboard bishopAttacks(Square::Index index, Bitboard occupied) {
+        const SliderTable& table = bishop_tables[index];
+        assert(table.attacks != nullptr && "Bitboards::init() not called");
+        return table.attacks[table.slot(occupied)];
+    }
+
+    inline Bitboard queenAttacks(Square::Index index, Bitboard occupied) {
+        return rookAttacks(index, occupied) | bishopAttacks(index, occupied);
+    }
+
+    //Filled in by init()
+    extern std::array<std::array<Bitboard, 64>, 64> between_squares;
+    extern std::array<std::array<Bitboard, 64>, 64> line_squares;
+
+    //Squares strictly between two squares on a shared rank, file or diagonal, empty if they share none
+    inline Bitboard between(Square::Index from, Square::Index to) {
+        return between_squares[from][to];
+    }
+
+    //Full rank, file or diagonal through both squares, empty if they share none
+    inline Bitboard line(Square::Index from, Square::Index to) {
+        return line_squares[from][to];
+    }
+
+    //Slow reference implementation walking the rays, used to build the tables
+    Bitboard slidingAttacks(Square::Index index, Bitboard occupied, const int (&deltas)[4][2]);
+
+    constexpr int rook_deltas[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+    constexpr int bishop_deltas[4][2] = {{1, 1}, {1, -1}, {-1, -1}, {-1, 1}};
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Board.hpp"
 
+#include <algorithm>
 #include <cmath>
 #include <ostream>
 
@@ -19,16 +20,9 @@ bool operator== (const ColorPositions& c1, const ColorPositions& c2)
             c1.black == c2.black);
 }
 
-
-bool operator==(const Repetition &r1, const Repetition &r2) {
-    return (r1.piece_positions == r2.piece_positions &&
-            r1.turn == r2.turn &&
-            r1.en_passant_square == r2.en_passant_square &&
-            r1.castling_rights == r2.castling_rights);
-}
-
 bool operator==(const Board &b1, const Board& b2) {
-    return (b1.piecePositions() == b2.piecePositions() &&
+    return (b1.hash() == b2.hash() &&
+            b1.piecePositions() == b2.piecePositions() &&
             b1.colorPositions() == b2.colorPositions() &&
             b1.turn() == b2.turn() &&
             b1.castlingRights() == b2.castlingRights() &&
@@ -39,71 +33,29 @@ bool operator==(const Board &b1, const Board& b2) {
 void Board::setPiece(const Square& square, const Piece::Optional& piece) {
     Square::Index square_index = square.index();
 
-    switch (piece->color()) {
-        case PieceColor::White:
-            color_positions.white[square_index] = true;
-            color_positions.black[square_index] = false;
-            break;
-        case PieceColor::Black:
-            color_positions.black[square_index] = true;
-            color_positions.white[square_index] = false;
-            break;
-        default: //Never occurs
-            break;
+    Piece::Optional replaced_piece = mailbox[square_index];
+    if(replaced_piece.has_value()) {
+        hash_key ^= Zobrist::piece(replaced_piece->color(), replaced_piece->type(), square_index);
+        removePiece(square_index);
     }
 
-    //Clear bit in all bitboards (avoid checking for each one)
-    piece_positions.clearBit(square_index);
-
-    switch (piece->type()) {
-        case PieceType::Pawn:
-            piece_positions.pawns[square_index] = true;
-            break;
-        case PieceType::Knight:
-            piece_positions.knights[square_index] = true;
-            break;
-        case PieceType::Bishop:
-            piece_positions.bishops[square_index] = true;
-            break;
-        case PieceType::Rook:
-            piece_positions.rooks[square_index] = true;
-            break;
-        case PieceType::Queen:
-            piece_positions.queen[square_index] = true;
-            break;
-        case PieceType::King:
-            piece_positions.king[square_index] = true;
-            break;
-        default: //Never occurs
-            break;
+    if(piece.has_value()) {
+        hash_key ^= Zobrist::piece(piece->color(), piece->type(), square_index);
+        addPiece(square_index, piece->color(), piece->type());
     }
 }
 
 
 Piece::Optional Board::piece(const Square& square) const {
     Square::Index index = square.index();
-    PieceColor color;
-
     if(isOutOfRange(index)) return std::nullopt;
-
-    if(color_positions.white[index]) color = PieceColor::White;
-    else if(color_positions.black[index]) color = PieceColor::Black;
-    else return std::nullopt;
-
-    char candidate_symbol = 'x'; //empty square
-    if(piece_positions.pawns[index]) candidate_symbol = 'p';
-    else if(piece_positions.knights[index]) candidate_symbol = 'n';
-    else if(piece_positions.bishops[index]) candidate_symbol = 'b';
-    else if(piece_positions.rooks[index]) candidate_symbol = 'r';
-    else if(piece_positions.queen[index]) candidate_symbol = 'q';
-    else if(piece_positions.king[index]) candidate_symbol = 'k';
-
-    if(color == PieceColor::White) return Piece::fromSymbol(toupper(candidate_symbol));
-    else return Piece::fromSymbol(candidate_symbol);
+    return mailbox[index];
 }
 
 void Board::setTurn(PieceColor turn) {
+    hash_key ^= stateKey();
     current_turn = turn;
+    hash_key ^= stateKey();
 }
 
 PieceColor Board::turn() const {
@@ -111,7 +63,9 @@ PieceColor Board::turn() const {
 }
 
 void Board::setCastlingRights(CastlingRights cr) {
+    hash_key ^= stateKey();
     castling_rights = cr;
+    hash_key ^= stateKey();
 }
 
 CastlingRights Board::castlingRights() const {
@@ -119,7 +73,9 @@ CastlingRights Board::castlingRights() const {
 }
 
 void Board::setEnPassantSquare(const Square::Optional& square) {
+    hash_key ^= stateKey();
     en_passant_square = square;
+    hash_key ^= stateKey();
 }
 
 Square::Optional Board::enPassantSquare() const {
@@ -143,35 +99,170 @@ ColorPositions Board::colorPositions() const {
 }
 
 unsigned Board::getAmountOfPiece(PieceColor color, PieceType piece_type) const {
-    std::bitset<64> color_bits;
-    switch(color) {
-        case PieceColor::White :
-            color_bits = color_positions.white;
-            break;
-        case PieceColor::Black :
-            color_bits = color_positions.black;
-            break;
-    }
+    Bitboard color_bits = getColorPositions(color);
 
     switch(piece_type) {
         case PieceType::Pawn :
-            return (color_bits & piece_positions.pawns).count();
+            return Bitboards::popCount(color_bits & piece_positions.pawns);
         case PieceType::Rook :
-            return (color_bits & piece_positions.rooks).count();
+            return Bitboards::popCount(color_bits & piece_positions.rooks);
         case PieceType::Bishop :
-            return (color_bits & piece_positions.bishops).count();
+            return Bitboards::popCount(color_bits & piece_positions.bishops);
         case PieceType::Knight :
-            return (color_bits & piece_positions.knights).count();
+            return Bitboards::popCount(color_bits & piece_positions.knights);
         case PieceType::Queen :
-            return (color_bits & piece_positions.queen).count();
+            return Bitboards::popCount(color_bits & piece_positions.queen);
         case PieceType::King :
-            return (color_bits & piece_positions.king).count();
+            return Bitboards::popCount(color_bits & piece_positions.king);
     }
     // never reached
     return 0;
 }
 
-std::bitset<64> Board::getColorPositions(PieceColor turn) const {
+bool Board::isCapture(const Move& move) const {
+    if(mailbox[move.toIndex()].has_value()) return true;
+    return en_passant_square.has_value() && move.to() == en_passant_square.value() &&
+           Bitboards::isSet(piece_positions.pawns, move.fromIndex());
+}
+
+//Piece values of the exchange evaluation, a king can only capture last
+static constexpr std::array<int, 6> see_values = {100, 300, 300, 500, 900, 20000};
+
+static int seeValue(PieceType type) {
+    return see_values[static_cast<std::size_t>(type)];
+}
+
+int Board::see(const Move& move) const {
+    Square::Index to_index = move.toIndex();
+    Bitboard occupancy = occupied() ^ Bitboards::squareBit(move.fromIndex());
+
+    int gain[32];
+    gain[0] = mailbox[to_index].has_value() ? seeValue(mailbox[to_index]->type()) : 0;
+    if(!mailbox[to_index].has_value() && isCapture(move)) { //en passant
+        gain[0] = seeValue(PieceType::Pawn);
+        occupancy ^= Bitboards::squareBit(backIndex(to_index));
+    }
+
+    PieceType on_square = mailbox[move.fromIndex()]->type();
+    if(move.isPromotion()) {
+        on_square = move.promotion().value();
+        gain[0] += seeValue(on_square) - seeValue(PieceType::Pawn);
+    }
+
+    //Sliders behind a capturing piece join in once it has left, attackers are therefore looked up again after each capture
+    Bitboard straight_sliders = piece_positions.rooks | piece_positions.queen;
+    Bitboard diagonal_sliders = piece_positions.bishops | piece_positions.queen;
+    Bitboard attackers = attackersTo(to_index, occupancy) & occupancy;
+    PieceColor side = !current_turn;
+    int depth = 0;
+
+    while(true) {
+        Bitboard side_attackers = attackers & getColorPositions(side);
+        if(!side_attackers) break;
+
+        Bitboard attacker_bits = 0;
+        PieceType attacker_type = leastValuableAttacker(side_attackers, attacker_bits);
+
+        //The king cannot capture onto a square that is still attacked
+        if(attacker_type == PieceType::King && (attackers & getColorPositions(!side))) break;
+
+        depth++;
+        gain[depth] = seeValue(on_square) - gain[depth - 1];
+        on_square = attacker_type;
+
+        occupancy ^= Bitboards::squareBit(Bitboards::lsb(attacker_bits));
+        attackers |= (Bitboards::rookAttacks(to_index, occupancy) & straight_sliders)
+                   | (Bitboards::bishopAttacks(to_index, occupancy) & diagonal_sliders);
+        attackers &= occupancy;
+        side = !side;
+    }
+
+    //Every side may stop capturing when continuing loses material
+    while(depth > 0) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+        depth--;
+    }
+    return gain[0];
+}
+
+//Same exchange as see(), but only the sign of the balance against the threshold is tracked, which lets the
+//loop stop as soon as the side to recapture can no longer change the outcome
+bool Board::seeGe(const Move& move, int threshold) const {
+    Square::Index to_index = move.toIndex();
+    Bitboard occupancy = occupied() ^ Bitboards::squareBit(move.fromIndex());
+
+    int balance = mailbox[to_index].has_value() ? seeValue(mailbox[to_index]->type()) : 0;
+    if(!mailbox[to_index].has_value() && isCapture(move)) { //en passant
+        balance = seeValue(PieceType::Pawn);
+        occupancy ^= Bitboards::squareBit(backIndex(to_index));
+    }
+
+    PieceType on_square = mailbox[move.fromIndex()]->type();
+    if(move.isPromotion()) {
+        on_square = move.promotion().value();
+        balance += seeValue(on_square) - seeValue(PieceType::Pawn);
+    }
+
+    //Not enough even if the move is never answered
+    balance -= threshold;
+    if(balance < 0) return false;
+
+    //Enough even if the moved piece is lost for nothing
+    balance = seeValue(on_square) - balance;
+    if(balance <= 0) return true;
+
+    Bitboard straight_sliders = piece_positions.rooks | piece_positions.queen;
+    Bitboard diagonal_sliders = piece_positions.bishops | piece_positions.queen;
+    Bitboard attackers = attackersTo(to_index, occupancy) & occupancy;
+    PieceColor side = !current_turn;
+    bool result = true;
+
+    while(true) {
+        Bitboard side_attackers = attackers & getColorPositions(side);
+        if(!side_attackers) break;
+
+        //From here on the result is the one of the side that recaptures, unless it prefers to stop
+        result = !result;
+
+        Bitboard attacker_bits = 0;
+        PieceType attacker_type = leastValuableAttacker(side_attackers, attacker_bits);
+
+        //The king cannot capture onto a square that is still attacked
+        if(attacker_type == PieceType::King) return (attackers & getColorPositions(!side)) ? !result : result;
+
+        //Recapturing does not pay off even if the attacker survives
+        balance = seeValue(attacker_type) - balance;
+        if(balance < static_cast<int>(result)) break;
+
+        occupancy ^= Bitboards::squareBit(Bitboards::lsb(attacker_bits));
+        attackers |= (Bitboards::rookAttacks(to_index, occupancy) & straight_sliders)
+                   | (Bitboards::bishopAttacks(to_index, occupancy) & diagonal_sliders);
+        attackers &= occupancy;
+        side = !side;
+    }
+    return result;
+}
+
+//Sets the attacker bits to the pieces of the returned type, the cheapest one among the attackers
+PieceType Board::leastValuableAttacker(Bitboard attackers, Bitboard& attacker_bits) const {
+    for(PieceType type : {PieceType::Pawn, PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen}) {
+        Bitboard typed = 0;
+        switch(type) {
+            case PieceType::Pawn : typed = piece_positions.pawns; break;
+            case PieceType::Knight : typed = piece_positions.knights; break;
+            case PieceType::Bishop : typed = piece_positions.bishops; break;
+            case PieceType::Rook : typed = piece_positions.rooks; break;
+            case PieceType::Queen : typed = piece_positions.queen; break;
+            default : break;
+        }
+        attacker_bits = attackers & typed;
+        if(attacker_bits) return type;
+    }
+    attacker_bits = attackers & piece_positions.king;
+    return PieceType::King;
+}
+
+Bitboard Board::getColorPositions(PieceColor turn) const {
     switch (turn) {
         case PieceColor::White :
             return color_positions.white;
@@ -182,13 +273,15 @@ std::bitset<64> Board::getColorPositions(PieceColor turn) const {
     return 0;
 }
 
-Repetition Board::getRepetition() const {
-    Repetition rep;
-    rep.piece_positions = piece_positions;
-    rep.castling_rights = castling_rights;
-    rep.en_passant_square = en_passant_square;
-    rep.turn = current_turn;
-    return rep;
+Zobrist::Key Board::hash() const {
+    return hash_key;
+}
+
+//Keys of everything besides the pieces, XORed out before and back in after changing turn, rights or eps
+Zobrist::Key Board::stateKey() const {
+    Zobrist::Key key = Zobrist::turn(current_turn) ^ Zobrist::castling(castling_rights);
+    if(en_passant_square.has_value()) key ^= Zobrist::enPassant(en_passant_square->index());
+    return key;
 }
 
 /**************
@@ -198,18 +291,8 @@ Repetition Board::getRepetition() const {
  * ******************/
 
 bool Board::isPlayerChecked(PieceColor turn) const {
-    std::bitset<64> player_king;
-    switch(turn) {
-        case PieceColor::White :
-            player_king = color_positions.white & piece_positions.king;
-            break;
-        case PieceColor::Black :
-            player_king = color_positions.black & piece_positions.king;
-            break;
-    }
-    for(size_t i = 0; i < player_king.size(); i++) {
-        if(player_king[i]) return isSquareAttacked(turn, i);
-    }
+    Bitboard player_king = getColorPositions(turn) & piece_positions.king;
+    if(player_king) return isSquareAttacked(turn, Bitboards::lsb(player_king));
 
     //never reached
     return false;
@@ -224,54 +307,33 @@ bool Board::isPlayerChecked(PieceColor turn) const {
 
 //Returns the type of piece captured in case of a capture
 std::optional<PieceType> Board::clearCapturePiece(const Square &square, bool try_capture) {
-    Piece::Optional occupy_piece = piece(square);
-    if(occupy_piece.has_value()) {
-        switch (occupy_piece->type()) {
-            case PieceType::Pawn :
-                piece_positions.pawns[square.index()] = false;
-                break;
-            case PieceType::Knight :
-                piece_positions.knights[square.index()] = false;
-                break;
-            case PieceType::Bishop :
-                piece_positions.bishops[square.index()] = false;
-                break;
-            case PieceType::Rook :
-                piece_positions.rooks[square.index()] = false;
-                break;
-            case PieceType::Queen :
-                piece_positions.queen[square.index()] = false;
-                break;
-            case PieceType::King :
-                if(try_capture) return occupy_piece->type(); //early return to not clear colorpositions
-                else piece_positions.king[square.index()] = false;
-                break;
-        }
+    Square::Index index = square.index();
+    Piece::Optional occupy_piece = mailbox[index];
+    if(!occupy_piece.has_value()) return std::nullopt;
 
-        switch (occupy_piece->color()) {
-            case PieceColor::White :
-                color_positions.white[square.index()] = false;
-                break;
-            case PieceColor::Black :
-                color_positions.black[square.index()] = false;
-                break;
-        }
-        return occupy_piece->type();
-    } else return std::nullopt;
+    if(try_capture && occupy_piece->type() == PieceType::King) return PieceType::King; //early return to not clear the king
+
+    hash_key ^= Zobrist::piece(occupy_piece->color(), occupy_piece->type(), index);
+    removePiece(index);
+    return occupy_piece->type();
 }
 
 //Performs the current move/capture move and if king is taken, no pieces are modified but checkmate is set
-void Board::makeMove(const Move& move) {
+Board::UndoInfo Board::makeMove(const Move& move) {
+    UndoInfo undo{std::nullopt, castling_rights, en_passant_square, halfmove_counter, hash_key};
+
     Square from_square = move.from();
     Square::Index from_index = from_square.index();
-    Piece::Optional from_piece = piece(from_square);
+    Piece::Optional from_piece = mailbox[from_index];
     Square to_square = move.to();
     Square::Index to_index = to_square.index();
     std::optional<PieceType> promotion = move.promotion();
 
+    hash_key ^= stateKey();
+
     //Capturecheck is in clearpiece
     std::optional<PieceType> captured_piece = clearCapturePiece(to_square, true);
-
+    undo.captured_piece = captured_piece;
 
     if(captured_piece.has_value() && captured_piece.value() == PieceType::King) {
         //DO NOTHING
@@ -294,12 +356,12 @@ void Board::makeMove(const Move& move) {
                         if(std::signbit(move_distance)) {
                             //Queenside
                             clearCapturePiece(Square::A1, false);
-                            setPiece(Square::fromIndex(to_index + 1).value(), Piece(PieceColor::White, PieceType::Rook));
+                            setPiece(Square::fromIndexUnchecked(to_index + 1), Piece(PieceColor::White, PieceType::Rook));
                         }
                         else {
                             //Kingside
                             clearCapturePiece(Square::H1, false);
-                            setPiece(Square::fromIndex(to_index - 1).value(), Piece(PieceColor::White, PieceType::Rook));
+                            setPiece(Square::fromIndexUnchecked(to_index - 1), Piece(PieceColor::White, PieceType::Rook));
                         }
                     }
                     //Update castling rights
@@ -310,12 +372,12 @@ void Board::makeMove(const Move& move) {
                         if(std::signbit(move_distance)) {
                             //Queenside
                             clearCapturePiece(Square::A8, false);
-                            setPiece(Square::fromIndex(to_index + 1).value(), Piece(PieceColor::Black, PieceType::Rook));
+                            setPiece(Square::fromIndexUnchecked(to_index + 1), Piece(PieceColor::Black, PieceType::Rook));
                         }
                         else {
                             //Kingside
                             clearCapturePiece(Square::H8, false);
-                            setPiece(Square::fromIndex(to_index - 1).value(), Piece(PieceColor::Black, PieceType::Rook));
+                            setPiece(Square::fromIndexUnchecked(to_index - 1), Piece(PieceColor::Black, PieceType::Rook));
                         }
                     }
                     //Update castling rights
@@ -377,30 +439,15 @@ void Board::makeMove(const Move& move) {
             //eps capture
             if(en_passant_square.has_value()) {
                 if(to_square == en_passant_square){
-                    clearCapturePiece(Square::fromIndex(backIndex(en_passant_square->index())).value(), true); //Back square from perspective of current turn
+                    clearCapturePiece(Square::fromIndexUnchecked(backIndex(en_passant_square->index())), true); //Back square from perspective of current turn
                 }
                 en_passant_square = std::nullopt;
             }
-            //Check for new eps
-            if(square_color[to_index] == square_color[from_index] && (from_index % 8 == to_index % 8)) {
-                Square::Index left_index = leftIndex(to_index);
-                Square::Index right_index = rightIndex(to_index);
-
-                if(square_color[left_index] != square_color[to_index]) {
-                    Piece::Optional left_piece = piece(Square::fromIndex(left_index).value());
-                    if(left_piece.has_value()) {
-                        if(left_piece->type() == PieceType::Pawn && left_piece->color() == !current_turn) en_passant_square = Square::fromIndex(
-                                    frontIndex(from_index));
-                    }
-                }
-
-                if(square_color[right_index] != square_color[to_index]) {
-                    Piece::Optional right_piece = piece(Square::fromIndex(right_index).value());
-                    if(right_piece.has_value()) {
-                        if(right_piece->type() == PieceType::Pawn && right_piece->color() == !current_turn) en_passant_square = Square::fromIndex(
-                                    frontIndex(from_index));
-                    }
-                }
+            //Check for new eps (only set when an opponent pawn next to the pushed pawn can capture)
+            if(to_index == doublePushIndex(from_index)) {
+                Square::Index skipped_index = frontIndex(from_index);
+                Bitboard opponent_pawns = getColorPositions(!current_turn) & piece_positions.pawns;
+                if(Bitboards::pawnAttacks(current_turn, skipped_index) & opponent_pawns) en_passant_square = Square::fromIndexUnchecked(skipped_index);
             }
 
         } else if (en_passant_square.has_value()) en_passant_square = std::nullopt; //if not a pawn move and there was eps, eps is expired
@@ -428,257 +475,94 @@ void Board::makeMove(const Move& move) {
 
     //Turn changes
     current_turn = !current_turn;
-}
 
+    hash_key ^= stateKey();
 
+    return undo;
+}
 
-/********************************************************
- *
- * MOVE GENERATION
- *
- * *****************************************************************/
+//Takes back a move made with makeMove, undo must be the record it returned
+void Board::unmakeMove(const Move& move, const UndoInfo& undo) {
+    //Turn changes back to the player that made the move
+    current_turn = !current_turn;
 
-bool Board::isSquareAttacked(PieceColor turn, Square::Index index) const {
+    //Pieces are put back without touching the hash key, it is restored from the undo record afterwards
+    if(undo.captured_piece != PieceType::King) { //King captures did not modify the pieces
+        Square::Index from_index = move.fromIndex();
+        Square::Index to_index = move.toIndex();
 
-    bool index_color = square_color[index];
+        PieceType moved_type = move.isPromotion() ? PieceType::Pawn : mailbox[to_index]->type();
+        removePiece(to_index);
+        addPiece(from_index, current_turn, moved_type);
 
-    //sliding pieces (Q/B/R)
-    Square::Index working_index = frontIndex(index, turn);
-    //N
-    while(!isOutOfRange(working_index)) {
-        std::optional<PieceColor> occupying = checkOccupation(working_index);
-        if(checkOccupation(working_index).has_value()) {
-            if(occupying != turn) {
-                if(working_index == frontIndex(index, turn) && piece_positions.king[working_index]) return true;
-                if(piece_positions.rooks[working_index] || piece_positions.queen[working_index]) return true;
-                else break;
-            }
-            else break;
-        }
-        else working_index = frontIndex(working_index, turn);
-    }
-    //S
-    working_index = backIndex(index, turn);
-    while(!isOutOfRange(working_index)) {
-        std::optional<PieceColor> occupying = checkOccupation(working_index);
-        if(checkOccupation(working_index).has_value()) {
-            if(occupying != turn) {
-                if(working_index == backIndex(index, turn) && piece_positions.king[working_index]) return true;
-                if(piece_positions.rooks[working_index] || piece_positions.queen[working_index]) return true;
-                else break;
-            }
-            else break;
+        if(undo.captured_piece.has_value()) {
+            addPiece(to_index, !current_turn, undo.captured_piece.value());
+        } else if(moved_type == PieceType::Pawn && undo.en_passant_square.has_value() && undo.en_passant_square->index() == to_index) {
+            //eps capture, the captured pawn was behind the eps from the perspective of the current turn
+            addPiece(backIndex(to_index), !current_turn, PieceType::Pawn);
         }
-        else working_index = backIndex(working_index, turn);
-    }
-    //E
-    working_index = rightIndex(index, turn);
-    if(square_color[working_index] != index_color) {
-        while(!isOutOfRange(working_index)) {
-            std::optional<PieceColor> occupying = checkOccupation(working_index);
-            if(checkOccupation(working_index).has_value()) {
-                if(occupying != turn) {
-                    if(working_index == rightIndex(index, turn) && piece_positions.king[working_index]) return true;
-                    if(piece_positions.rooks[working_index] || piece_positions.queen[working_index]) return true;
-                    else break;
-                }
-                else break;
-            }
-            else {
-                Square::Index new_index = rightIndex(working_index, turn);
-                if(square_color[new_index] == square_color[working_index]) break;
-                else working_index = new_index;
-            }
-        }
-    }
 
-    //W
-    working_index = leftIndex(index, turn);
-    if(square_color[working_index] != index_color) {
-        while(!isOutOfRange(working_index)) {
-            std::optional<PieceColor> occupying = checkOccupation(working_index);
-            if(checkOccupation(working_index).has_value()) {
-                if(occupying != turn) {
-                    if(working_index == leftIndex(index, turn) && piece_positions.king[working_index]) return true;
-                    if(piece_positions.rooks[working_index] || piece_positions.queen[working_index]) return true;
-                    else break;
-                }
-                else break;
-            }
-            else {
-                Square::Index new_index = leftIndex(working_index, turn);
-                if(square_color[new_index] == square_color[working_index]) break;
-                else working_index = new_index;
-            }
-        }
-    }
-
-    //NE
-    working_index = frontRightIndex(index, turn);
-    if(square_color[working_index] == index_color) {
-        while(!isOutOfRange(working_index)) {
-            std::optional<PieceColor> occupying = checkOccupation(working_index);
-            if(checkOccupation(working_index).has_value()) {
-                if(occupying != turn) {
-                    if(working_index == frontRightIndex(index, turn) && (piece_positions.pawns[working_index] || piece_positions.king[working_index])) return true;
-                    if(piece_positions.bishops[working_index] || piece_positions.queen[working_index]) return true;
-                    else break;
-                }
-                else break;
-            }
-            else {
-                Square::Index new_index = frontRightIndex(working_index, turn);
-                if(square_color[new_index] != square_color[working_index]) break;
-                else working_index = new_index;
+        //Castling move: also moves the rook back!
+        if(moved_type == PieceType::King && abs(static_cast<signed>(to_index) - static_cast<signed>(from_index)) == 2) {
+            if(to_index > from_index) {
+                //Kingside
+                removePiece(to_index - 1);
+                addPiece(to_index + 1, current_turn, PieceType::Rook);
+            } else {
+                //Queenside
+                removePiece(to_index + 1);
+                addPiece(to_index - 2, current_turn, PieceType::Rook);
             }
         }
     }
 
-    //NW
-    working_index = frontLeftIndex(index, turn);
-    if(square_color[working_index] == index_color) {
-        while(!isOutOfRange(working_index)) {
-            std::optional<PieceColor> occupying = checkOccupation(working_index);
-            if(checkOccupation(working_index).has_value()) {
-                if(occupying != turn) {
-                    if(working_index == frontLeftIndex(index, turn) && (piece_positions.pawns[working_index] || piece_positions.king[working_index])) return true;
-                    if(piece_positions.bishops[working_index] || piece_positions.queen[working_index]) return true;
-                    else break;
-                }
-                else break;
-            }
-            else {
-                Square::Index new_index = frontLeftIndex(working_index, turn);
-                if(square_color[new_index] != square_color[working_index]) break;
-                else working_index = new_index;
-            }
-        }
-    }
+    castling_rights = undo.castling_rights;
+    en_passant_square = undo.en_passant_square;
+    halfmove_counter = undo.halfmove_counter;
+    hash_key = undo.hash_key;
+}
 
-    //SE
-    working_index = backRightIndex(index, turn);
-    if(square_color[working_index] == index_color) {
-        while(!isOutOfRange(working_index)) {
-            std::optional<PieceColor> occupying = checkOccupation(working_index);
-            if(checkOccupation(working_index).has_value()) {
-                if(occupying != turn) {
-                    if(working_index == backRightIndex(index, turn) && piece_positions.king[working_index]) return true;
-                    if(piece_positions.bishops[working_index] || piece_positions.queen[working_index]) return true;
-                    else break;
-                }
-                else break;
-            }
-            else {
-                Square::Index new_index = backRightIndex(working_index, turn);
-                if(square_color[new_index] != square_color[working_index]) break;
-                else working_index = new_index;
-            }
-        }
-    }
+Board::UndoInfo Board::makeNullMove() {
+    UndoInfo undo{std::nullopt, castling_rights, en_passant_square, halfmove_counter, hash_key};
 
-    //SW
-    working_index = backLeftIndex(index, turn);
-    if(square_color[working_index] == index_color) {
-        while(!isOutOfRange(working_index)) {
-            std::optional<PieceColor> occupying = checkOccupation(working_index);
-            if(checkOccupation(working_index).has_value()) {
-                if(occupying != turn) {
-                    if(working_index == backLeftIndex(index, turn) && piece_positions.king[working_index]) return true;
-                    if(piece_positions.bishops[working_index] || piece_positions.queen[working_index]) return true;
-                    else break;
-                }
-                else break;
-            }
-            else {
-                Square::Index new_index = backLeftIndex(working_index, turn);
-                if(square_color[new_index] != square_color[working_index]) break;
-                else working_index = new_index;
-            }
-        }
-    }
+    hash_key ^= stateKey();
+    en_passant_square = std::nullopt;
+    current_turn = !current_turn;
+    halfmove_counter++;
+    hash_key ^= stateKey();
 
-    ///knights
-    //front
-    if(!isOutOfRange(frontIndex(frontIndex(index, turn), turn))) {
-        Square::Index front_left_index = frontLeftIndex(frontIndex(index, turn), turn);
-        Square::Index front_right_index = frontRightIndex(frontIndex(index, turn), turn);
+    return undo;
+}
 
-        if(square_color[front_left_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(front_left_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[front_left_index]) return true;
-            }
-        }
+void Board::unmakeNullMove(const UndoInfo& undo) {
+    current_turn = !current_turn;
+    en_passant_square = undo.en_passant_square;
+    halfmove_counter = undo.halfmove_counter;
+    hash_key = undo.hash_key;
+}
 
-        if(square_color[front_right_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(front_right_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[front_right_index]) return true;
-            }
-        }
 
-    }
-    //back
-    if(!isOutOfRange(backIndex(backIndex(index, turn), turn))) {
-        Square::Index back_left_index = backLeftIndex(backIndex(index, turn), turn);
-        Square::Index back_right_index = backRightIndex(backIndex(index, turn), turn);
-
-        if(square_color[back_left_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(back_left_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[back_left_index]) return true;
-            }
-        }
 
-        if(square_color[back_right_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(back_right_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[back_right_index]) return true;
-            }
-        }
+/********************************************************
+ *
+ * MOVE GENERATION
+ *
+ * *****************************************************************/
 
-    }
-    //left and right
-    Square::Index left_front_index = frontLeftIndex(leftIndex(index, turn), turn);
-    Square::Index left_back_index = backLeftIndex(leftIndex(index, turn), turn);
-    Square::Index right_front_index = frontRightIndex(rightIndex(index, turn), turn);
-    Square::Index right_back_index = backRightIndex(rightIndex(index, turn), turn);
-
-    if(!isOutOfRange(left_front_index)) {
-        if(square_color[left_front_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(left_front_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[left_front_index]) return true;
-            }
-        }
-    }
+bool Board::isSquareAttacked(PieceColor turn, Square::Index index) const {
 
-    if(!isOutOfRange(left_back_index)) {
-        if(square_color[left_back_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(left_back_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[left_back_index]) return true;
-            }
-        }
-    }
+    Bitboard opponent_positions = getColorPositions(!turn);
 
-    if(!isOutOfRange(right_front_index)) {
-        if(square_color[right_front_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(right_front_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[right_front_index]) return true;
-            }
-        }
-    }
+    //leaping pieces (N/K/P) are looked up in the precomputed attack tables
+    if(Bitboards::knight_attacks[index] & opponent_positions & piece_positions.knights) return true;
+    if(Bitboards::king_attacks[index] & opponent_positions & piece_positions.king) return true;
+    if(Bitboards::pawnAttacks(turn, index) & opponent_positions & piece_positions.pawns) return true;
 
-    if(!isOutOfRange(right_back_index)) {
-        if(square_color[right_back_index] != index_color) {
-            std::optional<PieceColor> occupying = checkOccupation(right_back_index);
-            if(occupying.has_value() && occupying != turn) {
-                if(piece_positions.knights[right_back_index]) return true;
-            }
-        }
-    }
+    //sliding pieces (Q/B/R)
+    Bitboard straight_sliders = opponent_positions & (piece_positions.rooks | piece_positions.queen);
+    if(Bitboards::rookAttacks(index, occupied()) & straight_sliders) return true;
+    Bitboard diagonal_sliders = opponent_positions & (piece_positions.bishops | piece_positions.queen);
+    if(Bitboards::bishopAttacks(index, occupied()) & diagonal_sliders) return true;
 
     //en passant
     if(en_passant_square.has_value() && en_passant_square->index() == backIndex(index, turn)) return true;
@@ -689,26 +573,16 @@ bool Board::isSquareAttacked(PieceColor turn, Square::Index index) const {
 
 //Generate pseudolegal moves for the current player
 void Board::pseudoLegalMoves( MoveVec& moves ) const {
-    std::bitset<64> current_turn_pieces;
-
-    switch (current_turn) {
-        case PieceColor::White:
-            current_turn_pieces = color_positions.white;
-            break;
-        case PieceColor::Black:
-            current_turn_pieces = color_positions.black;
-            break;
-    }
-
-    for(Square::Index piece_index = 0; piece_index < 64 ; piece_index++) {
-        if(current_turn_pieces[piece_index]) {
-            if(piece_positions.pawns[piece_index]) pseudoLegalPawnMovesFrom(piece_index, moves);
-            else if(piece_positions.king[piece_index]) pseudoLegalKingMovesFrom(piece_index, moves);
-            else if(piece_positions.knights[piece_index]) pseudoLegalKnightMovesFrom(piece_index, moves);
-            else if(piece_positions.rooks[piece_index]) pseudoLegalRookMovesFrom(piece_index, moves);
-            else if(piece_positions.bishops[piece_index]) pseudoLegalBishopMovesFrom(piece_index, moves);
-            else if(piece_positions.queen[piece_index]) pseudoLegalQueenMovesFrom(piece_index, moves);
-        }
+    Bitboard current_turn_pieces = getColorPositions(current_turn);
+
+    while(current_turn_pieces) {
+        Square::Index piece_index = Bitboards::popLsb(current_turn_pieces);
+        if(Bitboards::isSet(piece_positions.pawns, piece_index)) pseudoLegalPawnMovesFrom(piece_index, moves);
+        else if(Bitboards::isSet(piece_positions.king, piece_index)) pseudoLegalKingMovesFrom(piece_index, moves);
+        else if(Bitboards::isSet(piece_positions.knights, piece_index)) pseudoLegalKnightMovesFrom(piece_index, moves);
+        else if(Bitboards::isSet(piece_positions.rooks, piece_index)) pseudoLegalRookMovesFrom(piece_index, moves);
+        else if(Bitboards::isSet(piece_positions.bishops, piece_index)) pseudoLegalBishopMovesFrom(piece_index, moves);
+        else if(Bitboards::isSet(piece_positions.queen, piece_index)) pseudoLegalQueenMovesFrom(piece_index, moves);
     }
 }
 
@@ -745,172 +619,214 @@ void Board::pseudoLegalMovesFrom(const Square& from,
 
 }
 
+void Board::legalMoves(MoveVec& moves) const {
+    generateLegalMoves(moves, false);
+}
 
-void Board::pseudoLegalPawnMovesFrom(Square::Index pawn_index, Board::MoveVec& moves) const {
+void Board::legalCaptures(MoveVec& moves) const {
+    generateLegalMoves(moves, true);
+}
 
-    //Check occupation in front of pawn (pawn will never be resting in last rank)
-    Square current_square = Square::fromIndex(pawn_index).value();
-    Square::Index front_index = frontIndex(pawn_index);
-    std::optional<PieceColor> front_pawn = checkOccupation(front_index);
-
-    if(!front_pawn.has_value()){
-        Square front_square = Square::fromIndex(front_index).value();
-        if(promotionCandidate(pawn_index)) { //Second to last rank pawns
-            //Promotion to queen
-            moves.push_back(Move(current_square, front_square, PieceType::Queen));
-            //Promotion to rook
-            moves.push_back(Move(current_square, front_square, PieceType::Rook));
-            //Promotion to bishop
-            moves.push_back(Move(current_square, front_square, PieceType::Bishop));
-            //Promotion to knight
-            moves.push_back(Move(current_square, front_square, PieceType::Knight));
-        }
-        else { //Promotion is mandatory
-            moves.push_back(Move(current_square, front_square));
-            if(doublePushCandidate(pawn_index)) {
-                Square::Index double_push_index = doublePushIndex(pawn_index);
-                if(!checkOccupation(double_push_index).has_value()) {
-                    moves.push_back(Move(current_square, Square::fromIndex(doublePushIndex(pawn_index)).value()));
-                }
-            }
-        }
+//The move has to be generated from its square and pass the check and pin masks of generateLegalMoves
+bool Board::isLegal(const Move& move) const {
+    MoveVec moves;
+    pseudoLegalMovesFrom(move.from(), moves);
+    if(std::find(moves.begin(), moves.end(), move) == moves.end()) return false;
+
+    //Without a king nothing can be left in check
+    Bitboard own_king = getColorPositions(current_turn) & piece_positions.king;
+    if(!own_king) return true;
 
+    Square::Index king_index = Bitboards::lsb(own_king);
+    Square::Index from_index = move.fromIndex();
+    Square::Index to_index = move.toIndex();
+    Bitboard enemy_pieces = getColorPositions(!current_turn);
+
+    //Castling is only generated when legal, other king moves may not step onto an attacked square
+    if(from_index == king_index) return !(attackersTo(to_index, occupied() ^ own_king) & enemy_pieces);
+
+    if(mailbox[from_index]->type() == PieceType::Pawn && en_passant_square.has_value() &&
+       to_index == en_passant_square->index()) {
+        return legalEnPassant(from_index, king_index);
     }
 
-    Square::Index front_left_index = frontLeftIndex(pawn_index);
-    Square::Index front_right_index = frontRightIndex(pawn_index);
-
-    bool diag_color = square_color[pawn_index];
-
-    //Front left captures check
-    if(square_color[front_left_index] == diag_color) {
-        std::optional<PieceColor> front_left_pawn = checkOccupation(front_left_index);
-
-        if(front_left_pawn.has_value() && current_turn != front_left_pawn.value()) { //Capture possible
-            Square front_left_square = Square::fromIndex(front_left_index).value();
-            if(promotionCandidate(pawn_index)) { //Promotion
-                //Promotion to queen
-                moves.push_back(Move(current_square, front_left_square, PieceType::Queen));
-                //Promotion to rook
-                moves.push_back(Move(current_square, front_left_square, PieceType::Rook));
-                //Promotion to bishop
-                moves.push_back(Move(current_square, front_left_square, PieceType::Bishop));
-                //Promotion to knight
-                moves.push_back(Move(current_square, front_left_square, PieceType::Knight));
-            }
-            else { //Promotion is mandatory
-                moves.push_back(Move(current_square, front_left_square));
-            }
+    //A single check must be captured or blocked, in double check only the king can move
+    Bitboard checkers = attackersTo(king_index, occupied()) & enemy_pieces;
+    if(Bitboards::popCount(checkers) > 1) return false;
+    if(checkers && !Bitboards::isSet(checkers | Bitboards::between(king_index, Bitboards::lsb(checkers)), to_index)) return false;
+
+    //A pinned piece can only move along the line through its king and pinner
+    return !Bitboards::isSet(pinnedPieces(king_index), from_index) || Bitboards::isSet(Bitboards::line(king_index, from_index), to_index);
+}
+
+//Generate legal moves for the current player: check and pin masks restrict the targets of every piece
+//so no move has to be made to find out whether it leaves the king attacked
+void Board::generateLegalMoves(MoveVec& moves, bool captures_only) const {
+    Bitboard own_pieces = getColorPositions(current_turn);
+    Bitboard own_king = own_pieces & piece_positions.king;
+    Bitboard enemy_pieces = getColorPositions(!current_turn);
+
+    //Without a king nothing can be left in check
+    if(!own_king) {
+        MoveVec pseudo_legal_moves;
+        pseudoLegalMoves(pseudo_legal_moves);
+        for(const Move& move : pseudo_legal_moves) {
+            if(!captures_only || isCapture(move) || move.isPromotion()) moves.push_back(move);
         }
+        return;
     }
 
-    //Front right captures check
-    if(square_color[front_right_index] == diag_color) {
-        std::optional<PieceColor> front_right_pawn = checkOccupation(front_right_index);
-
-        if(front_right_pawn.has_value() && current_turn != front_right_pawn.value()) { //Capture possible
-            Square front_right_square = Square::fromIndex(front_right_index).value();
-            if(promotionCandidate(pawn_index)) { //Promotion
-                //Promotion to queen
-                moves.push_back(Move(current_square, front_right_square, PieceType::Queen));
-                //Promotion to rook
-                moves.push_back(Move(current_square, front_right_square, PieceType::Rook));
-                //Promotion to bishop
-                moves.push_back(Move(current_square, front_right_square, PieceType::Bishop));
-                //Promotion to knight
-                moves.push_back(Move(current_square, front_right_square, PieceType::Knight));
-            }
-            else { //Promotion is mandatory
-                moves.push_back(Move(current_square, front_right_square));
-            }
+    Square::Index king_index = Bitboards::lsb(own_king);
+    Bitboard checkers = attackersTo(king_index, occupied()) & enemy_pieces;
+
+    //Captures only land on enemy pieces, pawns may also push onto the promotion rank
+    Bitboard capture_mask = captures_only ? enemy_pieces : ~Bitboard(0);
+    Bitboard promotion_rank = current_turn == PieceColor::White ? Bitboards::rank_8 : Bitboards::rank_1;
+    Bitboard pawn_capture_mask = captures_only ? enemy_pieces | promotion_rank : ~Bitboard(0);
+
+    //The king may not step onto an attacked square, sliders are looked up through it
+    Bitboard occupied_without_king = occupied() ^ own_king;
+    Bitboard king_targets = Bitboards::king_attacks[king_index] & ~own_pieces & capture_mask;
+    while(king_targets) {
+        Square::Index to_index = Bitboards::popLsb(king_targets);
+        if(!(attackersTo(to_index, occupied_without_king) & enemy_pieces)) {
+            moves.push_back(Move(Square::fromIndexUnchecked(king_index), Square::fromIndexUnchecked(to_index)));
         }
     }
 
-    //Check if en-passant move possible
-    if(en_passant_square.has_value()) {
-        Square::Index en_passant_index = en_passant_square->index();
+    //In double check only the king can move
+    if(Bitboards::popCount(checkers) > 1) return;
 
-        if(front_right_index == en_passant_index && square_color[front_right_index] == diag_color) {
-            moves.push_back(Move(current_square, Square::fromIndex(front_right_index).value()));
-        }
-        if (front_left_index == en_passant_index && square_color[front_left_index] == diag_color) {
-            moves.push_back(Move(current_square, Square::fromIndex(front_left_index).value()));
-        }
+    //A single check must be captured or blocked
+    Bitboard target_mask = ~Bitboard(0);
+    if(checkers) target_mask = checkers | Bitboards::between(king_index, Bitboards::lsb(checkers));
+    else if(!captures_only) castlingMovesFrom(king_index, moves);
+
+    Bitboard pinned = pinnedPieces(king_index);
+    Bitboard movable_pieces = own_pieces & ~own_king;
+    while(movable_pieces) {
+        Square::Index piece_index = Bitboards::popLsb(movable_pieces);
+        //A pinned piece can only move along the line through its king and pinner
+        Bitboard piece_mask = target_mask;
+        if(Bitboards::isSet(pinned, piece_index)) piece_mask &= Bitboards::line(king_index, piece_index);
 
+        Bitboard targets = 0;
+        switch(mailbox[piece_index]->type()) {
+            case PieceType::Pawn :
+                pawnMovesFrom(piece_index, piece_mask & pawn_capture_mask, moves);
+                if(canCaptureEnPassant(piece_index) && legalEnPassant(piece_index, king_index)) {
+                    moves.push_back(Move(Square::fromIndexUnchecked(piece_index), en_passant_square.value()));
+                }
+                continue;
+            case PieceType::Knight :
+                targets = Bitboards::knight_attacks[piece_index];
+                break;
+            case PieceType::Bishop :
+                targets = Bitboards::bishopAttacks(piece_index, occupied());
+                break;
+            case PieceType::Rook :
+                targets = Bitboards::rookAttacks(piece_index, occupied());
+                break;
+            case PieceType::Queen :
+                targets = Bitboards::queenAttacks(piece_index, occupied());
+                break;
+            case PieceType::King : //Handled above
+                continue;
+        }
+        movesFromTargets(piece_index, targets & ~own_pieces & piece_mask & capture_mask, moves);
     }
+}
 
+//Pieces of both colors attacking index, sliders are blocked by the given occupancy
+Bitboard Board::attackersTo(Square::Index index, Bitboard occupancy) const {
+    Bitboard straight_sliders = piece_positions.rooks | piece_positions.queen;
+    Bitboard diagonal_sliders = piece_positions.bishops | piece_positions.queen;
+
+    return (Bitboards::pawnAttacks(PieceColor::White, index) & color_positions.black & piece_positions.pawns)
+         | (Bitboards::pawnAttacks(PieceColor::Black, index) & color_positions.white & piece_positions.pawns)
+         | (Bitboards::knight_attacks[index] & piece_positions.knights)
+         | (Bitboards::king_attacks[index] & piece_positions.king)
+         | (Bitboards::rookAttacks(index, occupancy) & straight_sliders)
+         | (Bitboards::bishopAttacks(index, occupancy) & diagonal_sliders);
 }
 
-void Board::pseudoLegalKingMovesFrom(Square::Index king_index, Board::MoveVec &moves) const {
+//Own pieces that are the only blocker between the king and an enemy slider
+Bitboard Board::pinnedPieces(Square::Index king_index) const {
+    Bitboard own_pieces = getColorPositions(current_turn);
+    Bitboard enemy_pieces = getColorPositions(!current_turn);
 
-    Square current_square = Square::fromIndex(king_index).value();
+    Bitboard snipers = enemy_pieces & (
+            (Bitboards::rookAttacks(king_index, 0) & (piece_positions.rooks | piece_positions.queen))
+          | (Bitboards::bishopAttacks(king_index, 0) & (piece_positions.bishops | piece_positions.queen)));
 
-    Square::Index front_left_index = frontLeftIndex(king_index);
-    Square::Index front_right_index = frontRightIndex(king_index);
-    Square::Index back_left_index = backLeftIndex(king_index);
-    Square::Index back_right_index = backRightIndex(king_index);
-    Square::Index left_index = leftIndex(king_index);
-    Square::Index right_index = rightIndex(king_index);
+    Bitboard pinned = 0;
+    while(snipers) {
+        Bitboard blockers = Bitboards::between(king_index, Bitboards::popLsb(snipers)) & occupied();
+        if(Bitboards::popCount(blockers) == 1) pinned |= blockers & own_pieces;
+    }
+    return pinned;
+}
 
-    bool diag_color = square_color[king_index];
-
-    if(!lastRankCheck(king_index)) {
-        //Front
-        Square::Index front_index = frontIndex(king_index);
-        std::optional<PieceColor> front_piece = checkOccupation(front_index);
-        Square front_square = Square::fromIndex(front_index).value();
-        if(!front_piece.has_value()) moves.push_back(Move(current_square, front_square));
-        else if (front_piece.value() != current_turn) moves.push_back(Move(current_square, front_square));
-        //Front-Left
-        if(square_color[front_left_index] == diag_color) {
-            std::optional<PieceColor> front_left_piece = checkOccupation(front_left_index);
-            Square front_left_square = Square::fromIndex(front_left_index).value();
-            if(!front_left_piece.has_value()) moves.push_back(Move(current_square, front_left_square));
-            else if (front_left_piece.value() != current_turn) moves.push_back(Move(current_square, front_left_square));
-        }
-        //Front-Right
-        if(square_color[front_right_index] == diag_color) {
-            std::optional<PieceColor> front_right_piece = checkOccupation(front_right_index);
-            Square front_right_square = Square::fromIndex(front_right_index).value();
-            if(!front_right_piece.has_value()) moves.push_back(Move(current_square, front_right_square));
-            else if (front_right_piece.value() != current_turn) moves.push_back(Move(current_square, front_right_square));
-        }
+//En passant removes two pieces from a rank, so it is checked by looking at the king with the resulting occupancy
+bool Board::legalEnPassant(Square::Index pawn_index, Square::Index king_index) const {
+    Square::Index ep_index = en_passant_square->index();
+    Bitboard captured_bit = Bitboards::squareBit(backIndex(ep_index));
+    Bitboard occupancy = (occupied() ^ Bitboards::squareBit(pawn_index) ^ captured_bit) | Bitboards::squareBit(ep_index);
+
+    return !(attackersTo(king_index, occupancy) & getColorPositions(!current_turn) & ~captured_bit);
+}
+
+void Board::pseudoLegalPawnMovesFrom(Square::Index pawn_index, Board::MoveVec& moves) const {
+    pawnMovesFrom(pawn_index, ~Bitboard(0), moves);
+
+    if(canCaptureEnPassant(pawn_index)) {
+        moves.push_back(Move(Square::fromIndexUnchecked(pawn_index), en_passant_square.value()));
     }
-    if(!firstRankCheck(king_index)) {
-        //back
-        Square::Index back_index = backIndex(king_index);
-        std::optional<PieceColor> back_piece = checkOccupation(back_index);
-        Square back_square = Square::fromIndex(back_index).value();
-        if(!back_piece.has_value()) moves.push_back(Move(current_square, back_square));
-        else if (back_piece.value() != current_turn) moves.push_back(Move(current_square, back_square));
-        //back-Left
-        if(square_color[back_left_index] == diag_color) {
-            std::optional<PieceColor> back_left_piece = checkOccupation(back_left_index);
-            Square back_left_square = Square::fromIndex(back_left_index).value();
-            if(!back_left_piece.has_value()) moves.push_back(Move(current_square, back_left_square));
-            else if (back_left_piece.value() != current_turn) moves.push_back(Move(current_square, back_left_square));
-        }
-        //back-Right
-        if(square_color[back_right_index] == diag_color) {
-            std::optional<PieceColor> back_right_piece = checkOccupation(back_right_index);
-            Square back_right_square = Square::fromIndex(back_right_index).value();
-            if(!back_right_piece.has_value()) moves.push_back(Move(current_square, back_right_square));
-            else if (back_right_piece.value() != current_turn) moves.push_back(Move(current_square, back_right_square));
+}
+
+//Pushes and regular captures landing on target_mask, en passant is left to the caller
+void Board::pawnMovesFrom(Square::Index pawn_index, Bitboard target_mask, Board::MoveVec& moves) const {
+
+    Square current_square = Square::fromIndexUnchecked(pawn_index);
+    Bitboard empty_squares = ~occupied();
+
+    //Pushes, shifting off the board drops the bit so no range checks are needed
+    Bitboard targets = Bitboards::pawnPush(current_turn, Bitboards::squareBit(pawn_index)) & empty_squares;
+    if(targets && doublePushCandidate(pawn_index)) targets |= Bitboards::pawnPush(current_turn, targets) & empty_squares;
+
+    //Captures
+    targets |= Bitboards::pawnAttacks(current_turn, pawn_index) & getColorPositions(!current_turn);
+    targets &= target_mask;
+
+    if(promotionCandidate(pawn_index)) { //Promotion is mandatory
+        while(targets) {
+            Square target_square = Square::fromIndexUnchecked(Bitboards::popLsb(targets));
+            moves.push_back(Move(current_square, target_square, PieceType::Queen));
+            moves.push_back(Move(current_square, target_square, PieceType::Rook));
+            moves.push_back(Move(current_square, target_square, PieceType::Bishop));
+            moves.push_back(Move(current_square, target_square, PieceType::Knight));
         }
     }
+    else movesFromTargets(pawn_index, targets, moves);
+}
 
-    if(square_color[left_index] != diag_color) {
-        std::optional<PieceColor> left_piece = checkOccupation(left_index);
-        Square left_square = Square::fromIndex(left_index).value();
-        if(!left_piece.has_value()) moves.push_back(Move(current_square, left_square));
-        else if (left_piece.value() != current_turn) moves.push_back(Move(current_square, left_square));
-    }
-    if(square_color[right_index] != diag_color) {
-        std::optional<PieceColor> right_piece = checkOccupation(right_index);
-        Square right_square = Square::fromIndex(right_index).value();
-        if(!right_piece.has_value()) moves.push_back(Move(current_square, right_square));
-        else if (right_piece.value() != current_turn) moves.push_back(Move(current_square, right_square));
-    }
+bool Board::canCaptureEnPassant(Square::Index pawn_index) const {
+    return en_passant_square.has_value() &&
+           Bitboards::isSet(Bitboards::pawnAttacks(current_turn, pawn_index), en_passant_square->index());
+}
+
+void Board::pseudoLegalKingMovesFrom(Square::Index king_index, Board::MoveVec &moves) const {
+    movesFromTargets(king_index, Bitboards::king_attacks[king_index] & ~getColorPositions(current_turn), moves);
+    castlingMovesFrom(king_index, moves);
+}
+
+//Castling is only generated when legal: the king is not in check and does not pass or land on an attacked square
+void Board::castlingMovesFrom(Square::Index king_index, Board::MoveVec &moves) const {
+
+    Square current_square = Square::fromIndexUnchecked(king_index);
+
+    Square::Index left_index = leftIndex(king_index);
+    Square::Index right_index = rightIndex(king_index);
 
     //Castling moves
     if(!isSquareAttacked(current_turn, king_index)) {
@@ -922,7 +838,7 @@ void Board::pseudoLegalKingMovesFrom(Square::Index king_index, Board::MoveVec &m
                 if( static_cast<bool>(castling_rights & CastlingRights::WhiteKingside)) {
                     if(!checkOccupation(right_index).has_value() && !isSquareAttacked(PieceColor::White, right_index)) {
                         if(!checkOccupation(right_right_index).has_value() && !isSquareAttacked(PieceColor::White, right_right_index)) {
-                            moves.push_back(Move(current_square, Square::fromIndex(right_right_index).value()));
+                            moves.push_back(Move(current_square, Square::fromIndexUnchecked(right_right_index)));
                         }
                     }
                 }
@@ -930,7 +846,7 @@ void Board::pseudoLegalKingMovesFrom(Square::Index king_index, Board::MoveVec &m
                     if(!checkOccupation(left_index).has_value() && !isSquareAttacked(PieceColor::White, left_index)) {
                         if(!checkOccupation(left_left_index).has_value() && !isSquareAttacked(PieceColor::White, left_left_index)) {
                             //Extra queenside check due to bigger distance
-                            if(!checkOccupation(leftIndex(left_left_index)).has_value()) moves.push_back(Move(current_square, Square::fromIndex(left_left_index).value()));
+                            if(!checkOccupation(leftIndex(left_left_index)).has_value()) moves.push_back(Move(current_square, Square::fromIndexUnchecked(left_left_index)));
                         }
                     }
                 }
@@ -940,270 +856,99 @@ void Board::pseudoLegalKingMovesFrom(Square::Index king_index, Board::MoveVec &m
                     if(!checkOccupation(right_index).has_value() && !isSquareAttacked(PieceColor::Black, right_index)) {
                         if(!checkOccupation(right_right_index).has_value() && !isSquareAttacked(PieceColor::Black, right_right_index)) {
                             //Extra queenside check due to bigger distance
-                            if(!checkOccupation(rightIndex(right_right_index)).has_value()) moves.push_back(Move(current_square, Square::fromIndex(right_right_index).value()));
+                            if(!checkOccupation(rightIndex(right_right_index)).has_value()) moves.push_back(Move(current_square, Square::fromIndexUnchecked(right_right_index)));
                         }
                     }
                 }
                 if( static_cast<bool>(castling_rights & CastlingRights::BlackKingside)) {
                     if(!checkOccupation(left_index).has_value() && !isSquareAttacked(PieceColor::Black, left_index)) {
                         if(!checkOccupation(left_left_index).has_value() && !isSquareAttacked(PieceColor::Black, left_left_index)) {
-                            moves.push_back(Move(current_square, Square::fromIndex(left_left_index).value()));
+                            moves.push_back(Move(current_square, Square::fromIndexUnchecked(left_left_index)));
                         }
                     }
                 }
                 break;
         }
     }
-
 }
 
 void Board::pseudoLegalKnightMovesFrom(Square::Index knight_index, Board::MoveVec &moves) const {
-
-    Square current_square = Square::fromIndex(knight_index).value();
-    bool knight_square_color = square_color[knight_index];
-
-    //front knight
-    if(!isOutOfRange(frontIndex(frontIndex(knight_index)))) {
-        Square::Index front_left_index = frontLeftIndex(frontIndex(knight_index));
-        Square::Index front_right_index = frontRightIndex(frontIndex(knight_index));
-
-        if(square_color[front_left_index] != knight_square_color) {
-            std::optional<PieceColor> front_left_piece = checkOccupation(front_left_index);
-            Square front_left_square = Square::fromIndex(front_left_index).value();
-            if(!front_left_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, front_left_square));
-            } else if (front_left_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, front_left_square));
-            }
-        }
-
-        if(square_color[front_right_index] != knight_square_color) {
-            std::optional<PieceColor> front_right_piece = checkOccupation(front_right_index);
-            Square front_right_square = Square::fromIndex(front_right_index).value();
-            if(!front_right_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, front_right_square));
-            } else if (front_right_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, front_right_square));
-            }
-        }
-    }
-
-    //back knight
-    if(!isOutOfRange(backIndex(backIndex(knight_index)))) {
-        Square::Index back_left_index = backLeftIndex(backIndex(knight_index));
-        Square::Index back_right_index = backRightIndex(backIndex(knight_index));
-
-        if(square_color[back_left_index] != knight_square_color) {
-            std::optional<PieceColor> back_left_piece = checkOccupation(back_left_index);
-            Square back_left_square = Square::fromIndex(back_left_index).value();
-            if(!back_left_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, back_left_square));
-            } else if (back_left_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, back_left_square));
-            }
-        }
-
-        if(square_color[back_right_index] != knight_square_color) {
-            std::optional<PieceColor> back_right_piece = checkOccupation(back_right_index);
-            Square back_right_square = Square::fromIndex(back_right_index).value();
-            if(!back_right_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, back_right_square));
-            } else if (back_right_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, back_right_square));
-            }
-        }
-    }
-
-    //left and right knight
-    Square::Index left_front_index = frontLeftIndex(leftIndex(knight_index));
-    Square::Index left_back_index = backLeftIndex(leftIndex(knight_index));
-    Square::Index right_front_index = frontRightIndex(rightIndex(knight_index));
-    Square::Index right_back_index = backRightIndex(rightIndex(knight_index));
-
-    if(!isOutOfRange(left_front_index)) {
-        if(square_color[left_front_index] != knight_square_color) {
-            std::optional<PieceColor> left_front_piece = checkOccupation(left_front_index);
-            Square left_front_square = Square::fromIndex(left_front_index).value();
-            if(!left_front_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, left_front_square));
-            } else if (left_front_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, left_front_square));
-            }
-        }
-    }
-
-    if(!isOutOfRange(left_back_index)) {
-        if(square_color[left_back_index] != knight_square_color) {
-            std::optional<PieceColor> left_back_piece = checkOccupation(left_back_index);
-            Square left_back_square = Square::fromIndex(left_back_index).value();
-            if(!left_back_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, left_back_square));
-            } else if (left_back_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, left_back_square));
-            }
-        }
-    }
-
-    if(!isOutOfRange(right_front_index)) {
-        if(square_color[right_front_index] != knight_square_color) {
-            std::optional<PieceColor> right_front_piece = checkOccupation(right_front_index);
-            Square right_front_square = Square::fromIndex(right_front_index).value();
-            if(!right_front_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, right_front_square));
-            } else if (right_front_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, right_front_square));
-            }
-        }
-    }
-
-    if(!isOutOfRange(right_back_index)) {
-        if(square_color[right_back_index] != knight_square_color) {
-            std::optional<PieceColor> right_back_piece = checkOccupation(right_back_index);
-            Square right_back_square = Square::fromIndex(right_back_index).value();
-            if(!right_back_piece.has_value()) { //Capture possible
-                moves.push_back(Move(current_square, right_back_square));
-            } else if (right_back_piece.value() != current_turn) {
-                moves.push_back(Move(current_square, right_back_square));
-            }
-        }
-    }
+    movesFromTargets(knight_index, Bitboards::knight_attacks[knight_index] & ~getColorPositions(current_turn), moves);
 }
 
 void Board::pseudoLegalRookMovesFrom(Square::Index rook_index, Board::MoveVec &moves) const {
-    Square current_square = Square::fromIndex(rook_index).value();
-
-    bool collided = false;
-
-    Square::Index work_front_index = frontIndex(rook_index);
-    while(!collided && !isOutOfRange(work_front_index)) {
-        std::optional<PieceColor> occupation = checkOccupation(work_front_index);
-        Square front_square = Square::fromIndex(work_front_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,front_square));
-            work_front_index = frontIndex(work_front_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, front_square));
-        }
-    }
-
-    collided = false;
-    Square::Index work_back_index = backIndex(rook_index);
-    while(!collided && !isOutOfRange(work_back_index)) {
-        std::optional<PieceColor> occupation = checkOccupation(work_back_index);
-        Square back_square = Square::fromIndex(work_back_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,back_square));
-            work_back_index = backIndex(work_back_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, back_square));
-        }
-    }
-
-    collided = false;
-    Square::Index work_left_index = leftIndex(rook_index);
-    while(!collided && abs(static_cast<signed>((rook_index / 8)) - static_cast<signed>((work_left_index / 8))) == 0) {
-        std::optional<PieceColor> occupation = checkOccupation(work_left_index);
-        Square left_square = Square::fromIndex(work_left_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,left_square));
-            work_left_index = leftIndex(work_left_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, left_square));
-        }
-    }
-
-    collided = false;
-    Square::Index work_right_index = rightIndex(rook_index);
-    while(!collided && abs(static_cast<signed>((rook_index / 8)) - static_cast<signed>((work_right_index / 8))) == 0) {
-        std::optional<PieceColor> occupation = checkOccupation(work_right_index);
-        Square right_square = Square::fromIndex(work_right_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,right_square));
-            work_right_index = rightIndex(work_right_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, right_square));
-        }
-    }
+    movesFromTargets(rook_index, Bitboards::rookAttacks(rook_index, occupied()) & ~getColorPositions(current_turn), moves);
 }
 
 void Board::pseudoLegalBishopMovesFrom(Square::Index bishop_index, Board::MoveVec &moves) const {
-    Square current_square = Square::fromIndex(bishop_index).value();
-
-    bool collided = false;
-    Square::Index work_front_left_index = frontLeftIndex(bishop_index);
-    bool start_color = square_color[bishop_index];
-
-    while(!collided && !isOutOfRange(work_front_left_index) && square_color[work_front_left_index] == start_color) {
-        std::optional<PieceColor> occupation = checkOccupation(work_front_left_index);
-        Square front_left_square = Square::fromIndex(work_front_left_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,front_left_square));
-            work_front_left_index = frontLeftIndex(work_front_left_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, front_left_square));
-        }
-    }
+    movesFromTargets(bishop_index, Bitboards::bishopAttacks(bishop_index, occupied()) & ~getColorPositions(current_turn), moves);
+}
 
-    collided = false;
-    Square::Index work_front_right_index = frontRightIndex(bishop_index);
+void Board::pseudoLegalQueenMovesFrom(Square::Index queen_index, Board::MoveVec &moves) const {
+    movesFromTargets(queen_index, Bitboards::queenAttacks(queen_index, occupied()) & ~getColorPositions(current_turn), moves);
+}
 
-    while(!collided && !isOutOfRange(work_front_right_index) && square_color[work_front_right_index] == start_color) {
-        std::optional<PieceColor> occupation = checkOccupation(work_front_right_index);
-        Square front_right_square = Square::fromIndex(work_front_right_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,front_right_square));
-            work_front_right_index = frontRightIndex(work_front_right_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, front_right_square));
-        }
-    }
+//Puts a piece on an empty square in the bitboards and the mailbox without touching the hash key
+void Board::addPiece(Square::Index index, PieceColor color, PieceType type) {
+    Bitboard square_bit = Bitboards::squareBit(index);
 
-    collided = false;
-    Square::Index work_back_right_index = backRightIndex(bishop_index);
+    switch(color) {
+        case PieceColor::White :
+            color_positions.white |= square_bit;
+            break;
+        case PieceColor::Black :
+            color_positions.black |= square_bit;
+            break;
+    }
 
-    while(!collided && !isOutOfRange(work_back_right_index) && square_color[work_back_right_index] == start_color) {
-        std::optional<PieceColor> occupation = checkOccupation(work_back_right_index);
-        Square back_right_square = Square::fromIndex(work_back_right_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,back_right_square));
-            work_back_right_index = backRightIndex(work_back_right_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, back_right_square));
-        }
+    switch(type) {
+        case PieceType::Pawn :
+            piece_positions.pawns |= square_bit;
+            break;
+        case PieceType::Knight :
+            piece_positions.knights |= square_bit;
+            break;
+        case PieceType::Bishop :
+            piece_positions.bishops |= square_bit;
+            break;
+        case PieceType::Rook :
+            piece_positions.rooks |= square_bit;
+            break;
+        case PieceType::Queen :
+            piece_positions.queen |= square_bit;
+            break;
+        case PieceType::King :
+            piece_positions.king |= square_bit;
+            break;
     }
 
-    collided = false;
-    Square::Index work_back_left_index = backLeftIndex(bishop_index);
+    mailbox[index] = Piece(color, type);
+}
 
-    while(!collided && !isOutOfRange(work_back_left_index) && square_color[work_back_left_index] == start_color) {
-        std::optional<PieceColor> occupation = checkOccupation(work_back_left_index);
-        Square back_left_square = Square::fromIndex(work_back_left_index).value();
-        if(!occupation.has_value()) {
-            moves.push_back(Move(current_square,back_left_square));
-            work_back_left_index = backLeftIndex(work_back_left_index);
-        } else {
-            collided = true;
-            if(occupation.value() != current_turn) moves.push_back(Move(current_square, back_left_square));
-        }
+//Clears an occupied square in the bitboards and the mailbox without touching the hash key
+void Board::removePiece(Square::Index index) {
+    Bitboard clear_mask = ~Bitboards::squareBit(index);
+    color_positions.white &= clear_mask;
+    color_positions.black &= clear_mask;
+    piece_positions.clearBit(index);
+    mailbox[index] = std::nullopt;
+}
+
+//Adds a move from the given square to every square in targets
+void Board::movesFromTargets(Square::Index from, Bitboard targets, Board::MoveVec& moves) const {
+    Square from_square = Square::fromIndexUnchecked(from);
+    while(targets) {
+        moves.push_back(Move(from_square, Square::fromIndexUnchecked(Bitboards::popLsb(targets))));
     }
 }
 
-void Board::pseudoLegalQueenMovesFrom(Square::Index index, Board::MoveVec &moves) const {
-    pseudoLegalRookMovesFrom(index, moves);
-    pseudoLegalBishopMovesFrom(index, moves);
+Bitboard Board::occupied() const {
+    return color_positions.white | color_positions.black;
 }
 
 std::optional<PieceColor> Board::checkOccupation(Square::Index index) const {
     //CAREFUL!: no index bound checking is done, so an empty return value could also mean it is out of bounds (not so safe access also, performance reasons)
-    if(color_positions.white[index]) return PieceColor::White;
-    else if(color_positions.black[index]) return PieceColor::Black;
+    if(mailbox[index].has_value()) return mailbox[index]->color();
     else return std::nullopt;
 }
 
@@ -1272,84 +1017,6 @@ Square::Index Board::doublePushIndex(Square::Index from, std::optional<PieceColo
     }
 }
 
-Square::Index Board::frontLeftIndex(Square::Index from, std::optional<PieceColor> turn) const {
-    PieceColor turn_to_use = current_turn;
-    if(turn.has_value()) turn_to_use = turn.value();
-    switch (turn_to_use) {
-        case PieceColor::White :
-            return from + 8 - 1;
-        case PieceColor::Black :
-            return from - 8 + 1;
-        default :
-            return 64; //Never occurs
-    }
-}
-
-Square::Index Board::backLeftIndex(Square::Index from, std::optional<PieceColor> turn) const {
-    PieceColor turn_to_use = current_turn;
-    if(turn.has_value()) turn_to_use = turn.value();
-    switch (turn_to_use) {
-        case PieceColor::White :
-            return from - 8 - 1;
-        case PieceColor::Black :
-            return from + 8 + 1;
-        default :
-            return 64; //Never occurs
-    }
-}
-
-Square::Index Board::backRightIndex(Square::Index from, std::optional<PieceColor> turn) const {
-    PieceColor turn_to_use = current_turn;
-    if(turn.has_value()) turn_to_use = turn.value();
-    switch (turn_to_use) {
-        case PieceColor::White :
-            return from - 8 + 1;
-        case PieceColor::Black :
-            return from + 8 - 1;
-        default :
-            return 64; //Never occurs
-    }
-}
-
-Square::Index Board::frontRightIndex(Square::Index from, std::optional<PieceColor> turn) const {
-    PieceColor turn_to_use = current_turn;
-    if(turn.has_value()) turn_to_use = turn.value();
-    switch (turn_to_use) {
-        case PieceColor::White :
-            return from + 8 + 1;
-        case PieceColor::Black :
-            return from - 8 - 1;
-        default :
-            return 64; //Never occurs
-    }
-}
-
-bool Board::firstRankCheck(Square::Index index, std::optional<PieceColor> turn) const {
-    PieceColor turn_to_use = current_turn;
-    if(turn.has_value()) turn_to_use = turn.value();
-    switch (turn_to_use) {
-        case PieceColor::White :
-            return (index <= 7);
-        case PieceColor::Black :
-            return (index >= 56 && index <= 63);
-        default : //Never reached
-            return false;
-    }
-}
-
-bool Board::lastRankCheck(Square::Index index, std::optional<PieceColor> turn) const {
-    PieceColor turn_to_use = current_turn;
-    if(turn.has_value()) turn_to_use = turn.value();
-    switch (turn_to_use) {
-        case PieceColor::White :
-            return (index >= 56 && index <= 63);
-        case PieceColor::Black :
-            return (index <= 7);
-        default : //Never reached
-            return false;
-    }
-}
-
 bool Board::isOutOfRange(Square::Index index) const {
     return index > 63;
 }
@@ -4,91 +4,56 @@
 #include "Piece.hpp"
 #include "Square.hpp"
 #include "Move.hpp"
+#include "MoveList.hpp"
 #include "CastlingRights.hpp"
+#include "Bitboard.hpp"
+#include "Zobrist.hpp"
 
 #include <optional>
 #include <iosfwd>
-#include <vector>
-#include <bitset>
+#include <array>
 
 
-//bitset: Default ctor bitset sets all bits to 0
-
-//All black squares on the board to aid calculations
-constexpr std::bitset<64> square_color = 0xAA55AA55AA55AA55;
-
-//Positions of the chess pieces independent of color
+//Positions of the chess pieces independent of color (value-initialized bitboards are empty)
 struct PiecePositions {
-    std::bitset<64> pawns;
-    std::bitset<64> knights;
-    std::bitset<64> bishops;
-    std::bitset<64> rooks;
-    std::bitset<64> queen;
-    std::bitset<64> king;
+    Bitboard pawns = 0;
+    Bitboard knights = 0;
+    Bitboard bishops = 0;
+    Bitboard rooks = 0;
+    Bitboard queen = 0;
+    Bitboard king = 0;
 
 
     void clearBit(Square::Index index) {
-        pawns[index] = 0;
-        knights[index] = 0;
-        bishops[index] = 0;
-        rooks[index] = 0;
-        queen[index] = 0;
-        king[index] = 0;
-    }
-};
-
-template<>
-struct std::hash<PiecePositions>
-{
-    std::size_t operator()(const PiecePositions& pieces) const {
-        return (std::hash<std::bitset<64>>{}(pieces.pawns) ^
-        std::hash<std::bitset<64>>{}(pieces.knights) ^
-        std::hash<std::bitset<64>>{}(pieces.bishops) ^
-        std::hash<std::bitset<64>>{}(pieces.rooks) ^
-        std::hash<std::bitset<64>>{}(pieces.queen) ^
-        std::hash<std::bitset<64>>{}(pieces.king));
+        Bitboard mask = ~Bitboards::squareBit(index);
+        pawns &= mask;
+        knights &= mask;
+        bishops &= mask;
+        rooks &= mask;
+        queen &= mask;
+        king &= mask;
     }
 };
 
-
 struct ColorPositions {
-    std::bitset<64> white;
-    std::bitset<64> black;
-};
-
-template<>
-struct std::hash<ColorPositions>
-{
-    std::size_t operator()(const ColorPositions& color) const {
-        return (std::hash<std::bitset<64>>{}(color.white) ^
-        std::hash<std::bitset<64>>{}(color.black));
-    }
-};
-
-
-struct Repetition {
-    PiecePositions piece_positions;
-    CastlingRights castling_rights;
-    Square::Optional en_passant_square;
-    PieceColor turn;
-};
-
-template<>
-struct std::hash<Repetition>
-{
-    std::size_t operator()(const Repetition& rep) const {
-        return (std::hash<PiecePositions>{}(rep.piece_positions) ^
-        std::hash<CastlingRights>{}(rep.castling_rights) ^
-        std::hash<Square::Optional>{}(rep.en_passant_square) ^
-        std::hash<PieceColor>{}(rep.turn));
-    }
+    Bitboard white = 0;
+    Bitboard black = 0;
 };
 
 class Board {
 public:
 
     using Optional = std::optional<Board>;
-    using MoveVec = std::vector<Move>;
+    using MoveVec = MoveList;
+
+    //Everything makeMove cannot recompute when taking a move back
+    struct UndoInfo {
+        std::optional<PieceType> captured_piece;
+        CastlingRights castling_rights;
+        Square::Optional en_passant_square;
+        int halfmove_counter;
+        Zobrist::Key hash_key;
+    };
 
     void setPiece(const Square& square, const Piece::Optional& piece);
     Piece::Optional piece(const Square& square) const;
@@ -103,49 +68,77 @@ public:
     PiecePositions piecePositions() const;
     ColorPositions colorPositions() const;
 
-    std::bitset<64> getColorPositions(PieceColor turn) const;
-    Repetition getRepetition() const;
+    Bitboard getColorPositions(PieceColor turn) const;
+
+    //Zobrist key of the position (pieces, turn, castling rights and en passant square, not the halfmove counter)
+    Zobrist::Key hash() const;
 
     bool isSquareAttacked(PieceColor turn, Square::Index index) const;
     bool isPlayerChecked(PieceColor turn) const;
 
+    //Whether the move takes a piece, en passant included
+    bool isCapture(const Move& move) const;
+
+    //Static exchange evaluation: material won by the move (in centipawns) when both sides keep recapturing on
+    //its target square with their least valuable piece, stopping whenever that is better for them
+    int see(const Move& move) const;
+
+    //Whether see(move) >= threshold, cheaper because the exchange stops once its outcome is decided
+    bool seeGe(const Move& move, int threshold) const;
+
     unsigned getAmountOfPiece(PieceColor color, PieceType piece_type) const;
 
-    void makeMove(const Move& move);
+    UndoInfo makeMove(const Move& move);
+    void unmakeMove(const Move& move, const UndoInfo& undo);
+
+    //Passes the turn to the opponent without moving (for null-move pruning), the side to move must not be in check
+    UndoInfo makeNullMove();
+    void unmakeNullMove(const UndoInfo& undo);
 
     void pseudoLegalMoves(MoveVec& moves) const;
     void pseudoLegalMovesFrom(const Square& from, MoveVec& moves) const;
 
+    //Only moves that do not leave the own king in check
+    void legalMoves(MoveVec& moves) const;
+
+    //Legal captures (en passant included) and promotions, the moves that change the material balance
+    void legalCaptures(MoveVec& moves) const;
+
+    //Whether a single move, for example one stored in the transposition table, is legal without generating every move
+    bool isLegal(const Move& move) const;
+
 private:
 
     PiecePositions piece_positions;
 
     ColorPositions color_positions;
 
-    PieceColor current_turn;
+    //Piece on every square, kept in sync with the bitboards for constant time lookups
+    std::array<Piece::Optional, 64> mailbox{};
+
+    PieceColor current_turn = PieceColor::White;
 
-    CastlingRights castling_rights;
+    CastlingRights castling_rights = CastlingRights::None;
 
     Square::Optional en_passant_square;
 
-    int halfmove_counter; //signed because of std::stoi
+    int halfmove_counter = 0; //signed because of std::stoi
+
+    //Kept up to date by every modification, an empty board with white to move hashes to 0
+    Zobrist::Key hash_key = 0;
+
+    Zobrist::Key stateKey() const;
 
     Square::Index frontIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
     Square::Index backIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
     Square::Index leftIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
     Square::Index rightIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
-    Square::Index backLeftIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
-    Square::Index backRightIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
-    Square::Index frontLeftIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
-    Square::Index frontRightIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt) const;
 
     bool promotionCandidate(Square::Index index) const;
 
     bool doublePushCandidate(Square::Index index) const;
     Square::Index doublePushIndex(Square::Index from, std::optional<PieceColor> turn = std::nullopt)  const;
 
-    bool firstRankCheck(Square::Index index, std::optional<PieceColor> turn = std::nullopt)  const;
-    bool lastRankCheck(Square::Index index, std::optional<PieceColor> turn = std::nullopt)  const;
     bool isOutOfRange(Square::Index index) const;
 
 
@@ -157,28 +150,32 @@ private:
     void pseudoLegalBishopMovesFrom(Square::Index index, Board::MoveVec& moves) const;
     void pseudoLegalQueenMovesFrom(Square::Index index, Board::MoveVec& moves) const;
 
+    void generateLegalMoves(MoveVec& moves, bool captures_only) const;
+
+    void pawnMovesFrom(Square::Index index, Bitboard target_mask, Board::MoveVec& moves) const;
+    bool canCaptureEnPassant(Square::Index pawn_index) const;
+    bool legalEnPassant(Square::Index pawn_index, Square::Index king_index) const;
+    void castlingMovesFrom(Square::Index king_index, Board::MoveVec& moves) const;
+
+    Bitboard attackersTo(Square::Index index, Bitboard occupancy) const;
+    PieceType leastValuableAttacker(Bitboard attackers, Bitboard& attacker_bits) const;
+    Bitboard pinnedPieces(Square::Index king_index) const;
+
+
+    void movesFromTargets(Square::Index from, Bitboard targets, Board::MoveVec& moves) const;
+
+    Bitboard occupied() const;
+
 
     std::optional<PieceType> clearCapturePiece(const Square& square, bool capture);
 
-    std::optional<PieceColor> checkOccupation(Square::Index index) const;
-};
+    void addPiece(Square::Index index, PieceColor color, PieceType type);
+    void removePiece(Square::Index index);
 
-template<>
-struct std::hash<Board>
-{
-    std::size_t operator()(const Board& board) const {
-        return (std::hash<PiecePositions>{}(board.piecePositions()) ^
-        std::hash<ColorPositions>{}(board.colorPositions()) ^
-        std::hash<PieceColor>{}(board.turn()) ^
-        std::hash<CastlingRights>{}(board.castlingRights()) ^
-        std::hash<Square::Optional>{}(board.enPassantSquare()) ^
-        std::hash<int>{}(board.halfMoveCounter()));
-    }
+    std::optional<PieceColor> checkOccupation(Square::Index index) const;
 };
 
-
 bool operator==(const Board &b1, const Board& b2);
-bool operator==(const Repetition &r1, const Repetition &r2);
 bool operator==(const PiecePositions &p1, const PiecePositions &p2);
 bool operator==(const ColorPositions &c1, const PiecePositions &c2);
 
@@ -3,11 +3,17 @@
 //
 
 #include "CheessEngine.hpp"
-#include <tuple>
 #include <map>
 #include <algorithm>
+#include <thread>
+#include <functional>
+#include <cmath>
 
-CheessEngine::CheessEngine() : max_transpo_size{50000000} { //Estimated based on 2GB / 40 bytes per entry
+CheessEngine::CheessEngine() : CheessEngine(std::make_shared<TranspositionTable>(default_hash_size * bytes_per_megabyte)) {
+
+}
+
+CheessEngine::CheessEngine(std::shared_ptr<TranspositionTable> table) : transposition_table{std::move(table)} {
 
 }
 
@@ -26,10 +32,19 @@ std::string CheessEngine::author() const {
 
 void CheessEngine::newGame() {
   //Reset state of the engine
-  repetition_map.clear();
-  transposition_table.clear();
+  game_history.clear();
+  //Another engine may be searching on a shared table, its entries stay valid in any game
+  if(transposition_table.use_count() == 1) transposition_table->clear();
 }
 
+const std::map<PieceType, PrincipalVariation::Score> piece_value { //Shannon point values
+        {PieceType::Pawn, 100},
+        {PieceType::Knight, 300},
+        {PieceType::Bishop, 300},
+        {PieceType::Rook, 500},
+        {PieceType::Queen, 900}
+};
+
 /*****************
  *
  * MOVE SEARCHING
@@ -37,105 +52,385 @@ void CheessEngine::newGame() {
  * ******************/
 
 PrincipalVariation CheessEngine::pv(const Board &board, const TimeInfo::Optional &timeInfo) {
-    timeInfo.has_value(); //Time control currently not implemented
-
-    //Iterative deepening of fixed depth of 5
-    SearchResult negamax_result;
-    for(int i = 0; i < 6; i++) {
-        negamax_result = negamaxSearch(board, i, -150000, 100000, 1);
-        if(abs(std::get<1>(negamax_result)) == 100000) {
-            std::reverse(std::get<0>(negamax_result).begin(), std::get<0>(negamax_result).end());
-            return PrincipalVariation(std::move(std::get<0>(negamax_result)), i, true);
-        }
+    time_manager = TimeManager(timeInfo, board.turn());
+    depth_limit = timeInfo.has_value() ? timeInfo->depth : std::nullopt;
+
+    //Every thread searches on its own mutable board, moves are made and taken back in place
+    SearchThread main_thread{board};
+
+    //The key stack starts with the end of the game, older positions cannot be repeated anymore
+    std::size_t game_length = std::min(game_history.size(), max_game_history);
+    std::copy(game_history.end() - game_length, game_history.end(), main_thread.keys.begin());
+    main_thread.game_length = static_cast<unsigned>(game_length);
+    main_thread.stack[0].plies_from_null = main_thread.game_length;
+    transposition_table->newSearch();
+
+    //Lazy SMP: helper threads search the same root and only share their results through the transposition table
+    stop_search = false;
+    std::vector<std::thread> helpers;
+    std::vector<SearchThread> helper_threads(thread_count - 1, main_thread);
+    for(std::size_t i = 0; i < helper_threads.size(); i++) {
+        helpers.emplace_back(&CheessEngine::helperSearch, this, std::ref(helper_threads[i]), i + 1);
     }
 
-    //Search until no longer losing
-    if(std::get<1>(negamax_result) < 0) {
-        int i = 6;
-        while(true) {
-            negamax_result = negamaxSearch(board, i, -150000, 100000, 1);
-            if(std::get<1>(negamax_result) >= 0) break; //can maybe cause unnecessary draws
-            else i++;
+    main_thread.is_main = true;
+    mainSearch(main_thread);
+
+    stop_search = true;
+    for(std::thread& helper : helpers) helper.join();
+
+    search_info.depth = main_thread.completed_depth;
+    search_info.nodes = main_thread.nodes;
+    search_info.quiescenceNodes = main_thread.qnodes;
+    for(const SearchThread& helper_thread : helper_threads) {
+        search_info.nodes += helper_thread.nodes;
+        search_info.quiescenceNodes += helper_thread.qnodes;
+    }
+
+    return completedPv(main_thread);
+}
+
+void CheessEngine::setGameHistory(const std::vector<Zobrist::Key>& history) {
+    game_history = history;
+}
+
+void CheessEngine::stop() {
+    stop_requested = true;
+}
+
+void CheessEngine::clearStop() {
+    stop_requested = false;
+}
+
+void CheessEngine::setPruningMargins(const PruningMargins& margins) {
+    pruning_margins = margins;
+}
+
+std::optional<SearchInfo> CheessEngine::searchInfo() const {
+    return search_info;
+}
+
+//Iterative deepening of the main thread, the last completed iteration is the one reported
+void CheessEngine::mainSearch(SearchThread& thread) {
+    std::optional<PrincipalVariation::Score> previous_score = std::nullopt;
+    for(unsigned depth = 1; depth <= max_depth; depth++) {
+        PrincipalVariation::Score score = aspirationSearch(thread, depth, previous_score);
+        if(stop_search) break; //Ran out of time, the unfinished iteration is discarded
+
+        std::copy(thread.pv_table[0].begin(), thread.pv_table[0].begin() + thread.pv_length[0], thread.completed_pv.begin());
+        thread.completed_length = thread.pv_length[0];
+        thread.completed_score = score;
+        previous_score = score;
+        thread.completed_depth = depth;
+
+        if(abs(score) >= mate_threshold || stop_requested) break;
+
+        if(depth_limit.has_value()) {
+            if(depth >= depth_limit.value()) break;
+        } else if(time_manager.isInfinite()) {
+            continue;
+        } else if(time_manager.hasLimits()) {
+            //The next iteration takes longer than all previous ones together, don't start it past the soft limit
+            if(time_manager.softLimitReached()) break;
+        } else if(depth >= default_depth && (score >= 0 || depth >= max_losing_depth)) {
+            //Without a clock: fixed depth, searching a bit deeper while losing (can maybe cause unnecessary draws)
+            break;
         }
     }
+}
+
+PrincipalVariation CheessEngine::completedPv(const SearchThread& thread) {
+    PrincipalVariation::MoveVec moves(thread.completed_pv.begin(), thread.completed_pv.begin() + thread.completed_length);
+    PrincipalVariation::Score score = thread.completed_score;
+    if(abs(score) >= mate_threshold) {
+        //Mate scores count down with the distance to the mate, the pv reports that distance in plies
+        PrincipalVariation::Score mate_plies = mate_score - abs(score);
+        return PrincipalVariation(std::move(moves), score > 0 ? mate_plies : -mate_plies, true);
+    }
+    return PrincipalVariation(std::move(moves), score, false);
+}
+
+//Helpers keep deepening until the main thread is done, odd helpers start one ply deeper so the threads spread over depths
+void CheessEngine::helperSearch(SearchThread& thread, std::size_t helper_index) {
+    std::optional<PrincipalVariation::Score> previous_score = std::nullopt;
+    for(unsigned depth = 1 + helper_index % 2; depth <= max_depth && !stop_search; depth++) {
+        previous_score = aspirationSearch(thread, depth, previous_score);
+    }
+}
 
-    std::reverse(std::get<0>(negamax_result).begin(), std::get<0>(negamax_result).end());
-    return PrincipalVariation(std::move(std::get<0>(negamax_result)), std::get<1>(negamax_result), false);
+//Searches the root with a narrow window around the previous iteration's score, most iterations land inside it
+//A score on the edge of the window only bounds the real score, the window is then widened on that side and searched again
+PrincipalVariation::Score CheessEngine::aspirationSearch(SearchThread& thread, unsigned depth, std::optional<PrincipalVariation::Score> previous_score) {
+    PrincipalVariation::Score alpha = -infinity_score;
+    PrincipalVariation::Score beta = infinity_score;
+    PrincipalVariation::Score delta = aspiration_window;
+    if(previous_score.has_value() && abs(previous_score.value()) < mate_threshold) {
+        alpha = previous_score.value() - delta;
+        beta = previous_score.value() + delta;
+    }
+
+    while(true) {
+        PrincipalVariation::Score score = negamaxSearch(thread, depth, alpha, beta, 0, true);
+        if(stop_search.load(std::memory_order_relaxed)) return score;
+
+        delta *= 2;
+        if(score <= alpha && alpha > -infinity_score) alpha = std::max(score - delta, -infinity_score);
+        else if(score >= beta && beta < infinity_score) beta = std::min(score + delta, infinity_score);
+        else return score;
+    }
 }
 
-CheessEngine::SearchResult CheessEngine::negamaxSearch(const Board &board, unsigned depth, PrincipalVariation::Score alpha, PrincipalVariation::Score beta, int turn) {
+//Returns the score of the position, its principal variation is left in the thread's pv table at ply
+PrincipalVariation::Score CheessEngine::negamaxSearch(SearchThread& thread, unsigned depth, PrincipalVariation::Score alpha, PrincipalVariation::Score beta, unsigned ply, bool null_move_allowed) {
+    Board& board = thread.board;
+    thread.keys[thread.game_length + ply] = board.hash();
+    thread.pv_length[ply] = 0;
+    if(visitNode(thread)) return 0;
+
+    //Draws by the fifty-move rule or repetition, never at the root which has to return a move
+    if(ply > 0 && (board.halfMoveCounter() >= 100 || isRepetition(thread, ply))) return 0;
+
+    //Tactics are resolved by searching captures only, instead of evaluating a position with pieces hanging
+    if(depth == 0) return quiescenceSearch(thread, alpha, beta, ply);
+
+    std::optional<Move> best_move = std::nullopt;
+    PrincipalVariation::Score original_alpha = alpha;
+
+    //The previous best move is searched first, a deep enough result ends the search of this node before generating moves
+    //A key collision can return the entry of another position, so the stored move is checked for legality first
+    std::optional<Move> tt_move = std::nullopt;
+    if(auto entry = transposition_table->probe(board.hash()); entry.has_value()) {
+        bool legal_move = board.isLegal(entry->move);
+        if(legal_move) tt_move = entry->move;
+        PrincipalVariation::Score entry_score = scoreFromTable(entry->score, ply);
+
+        if(ply > 0 && entry->depth >= depth) {
+            bool cutoff = entry->bound == TranspositionTable::Bound::Exact ||
+                          (entry->bound == TranspositionTable::Bound::Lower && entry_score >= beta) ||
+                          (entry->bound == TranspositionTable::Bound::Upper && entry_score <= alpha);
+            if(cutoff) {
+                if(legal_move) {
+                    thread.pv_table[ply][0] = entry->move;
+                    thread.pv_length[ply] = 1;
+                }
+                return std::clamp(entry_score, alpha, beta);
+            }
+        }
+    }
 
     //Generate moves, if no legal moves, check for stalemate/checkmate and assign score
-    Board::MoveVec possible_moves = generateLegalMoves(board);
+    Board::MoveVec possible_moves;
+    board.legalMoves(possible_moves);
 
     //No legal moves, checkmate or stalemate
     if(possible_moves.empty()) {
-        if(board.isPlayerChecked(board.turn())) return std::make_tuple(PrincipalVariation::MoveVec(),-100000); //checkmate
-        else return std::make_tuple(PrincipalVariation::MoveVec(),0); //stalemate
+        if(board.isPlayerChecked(board.turn())) return -mate_score + static_cast<PrincipalVariation::Score>(ply); //checkmate, faster mates score higher
+        else return 0; //stalemate
     }
 
-    if(depth == 0) return std::make_tuple(PrincipalVariation::MoveVec(), evalPosition(board)); //Return negamax score from current player's viewpoint
+    //Pruning relies on the static evaluation, which means nothing in check or with mate scores at stake
+    bool in_check = board.isPlayerChecked(board.turn());
+    bool can_prune = ply > 0 && !in_check && abs(alpha) < mate_threshold && abs(beta) < mate_threshold;
+    PrincipalVariation::Score static_eval = in_check ? -infinity_score : evalPosition(board);
 
+    auto depth_score = static_cast<PrincipalVariation::Score>(depth);
 
+    //Reverse futility pruning: this far above beta the opponent is not getting back in a few plies
+    if(can_prune && depth <= pruning_margins.reverse_futility_depth &&
+       static_eval - pruning_margins.reverse_futility_margin * depth_score >= beta) {
+        return beta;
+    }
 
-    std::optional<Move> best_move = std::nullopt;
-    PrincipalVariation::MoveVec best_pv;
-
-    //Check for previous best move and put it as first element
-    if(transposition_table.contains(board)) {
-        Move best_prev = transposition_table[board];
-        for(auto iter = possible_moves.begin(); iter != possible_moves.end(); iter++) {
-            if(*iter == best_prev) {
-                possible_moves.erase(iter);
-                break;
-            }
+    //Razoring: this far below alpha only tactics can help, if the quiescence search finds none the node fails low
+    if(can_prune && depth <= pruning_margins.razoring_depth &&
+       static_eval + pruning_margins.razoring_margin * depth_score <= alpha) {
+        PrincipalVariation::Score razor_score = quiescenceSearch(thread, alpha, alpha + 1, ply);
+        if(stop_search.load(std::memory_order_relaxed)) return 0;
+        if(razor_score <= alpha) return alpha;
+    }
+
+    //Futility pruning: quiet moves cannot raise a score this far below alpha in the few plies left
+    bool futile = can_prune && depth <= pruning_margins.futility_depth &&
+                  static_eval + pruning_margins.futility_margin * depth_score <= alpha;
+
+    //Null-move pruning: if passing still fails high, a real move almost surely does too
+    //Not in check, where passing is illegal, and not with pawns and at most one minor piece, where zugzwang makes passing the best "move"
+    if(null_move_allowed && can_prune && depth >= null_move_min_depth &&
+       hasNullMoveMaterial(board) && static_eval >= beta) {
+        unsigned reduced_depth = depth - 1 - std::min(depth - 1, null_move_reduction + depth / 4);
+
+        Board::UndoInfo undo = board.makeNullMove();
+        thread.stack[ply + 1].plies_from_null = 0;
+        PrincipalVariation::Score null_score = -negamaxSearch(thread, reduced_depth, -beta, -beta + 1, ply + 1, false);
+        board.unmakeNullMove(undo);
+
+        if(stop_search.load(std::memory_order_relaxed)) return 0;
+
+        if(null_score >= beta) {
+            //Deep cutoffs are verified by a reduced search without passing, catching zugzwang the material guard misses
+            if(depth < null_move_verification_depth) return beta;
+            PrincipalVariation::Score verified_score = negamaxSearch(thread, reduced_depth, beta - 1, beta, ply, false);
+            if(stop_search.load(std::memory_order_relaxed)) return 0;
+            if(verified_score >= beta) return beta;
         }
-        possible_moves.push_back(best_prev);
-        std::reverse(possible_moves.begin(), possible_moves.end());
     }
 
+    scoreMoves(thread, possible_moves, tt_move, ply);
+
+    for(std::size_t i = 0; i < possible_moves.size(); i++) {
+        //Lazy selection, after a cutoff the remaining moves never need to be sorted
+        possible_moves.selectBest(i);
+        const Move current_move = possible_moves[i];
+        bool quiet = !board.isCapture(current_move) && !current_move.isPromotion();
 
-    for(const Move& current_move : possible_moves){
-        Board copy_board(board);
         //MAKE MOVE
-        copy_board.makeMove(current_move);
+        Board::UndoInfo undo = board.makeMove(current_move);
 
+        //Moves giving check are kept, they are not quiet in effect
+        bool gives_check = board.isPlayerChecked(board.turn());
+        if(futile && i > 0 && quiet && !gives_check) {
+            board.unmakeMove(current_move, undo);
+            continue;
+        }
 
-        Repetition rep = copy_board.getRepetition();
-        repetition_map[rep]++; //inserts a new element initialized to 0 if key doesn't exist
+        thread.stack[ply + 1].plies_from_null = thread.stack[ply].plies_from_null + 1;
 
-        auto opponent_score = negamaxSearch(copy_board, depth - 1, -beta, -alpha, -turn);
-        PrincipalVariation::Score new_score = -1 * std::get<1>(opponent_score);
+        //Late move reductions: quiet moves ordered by history alone and losing captures (both scored below the killers)
+        //rarely turn out best, they are searched shallower unless either side is in check
+        unsigned reduction = 0;
+        if(i >= lmr_min_move_index && depth >= lmr_min_depth && !in_check &&
+           possible_moves.score(i) < killer_order - 1 && !gives_check) {
+            reduction = lateMoveReduction(depth, i);
+            reduction = std::min(reduction, depth - 2);
+        }
 
-        if(new_score < 0 && (copy_board.halfMoveCounter() >= 100 || repetition_map.at(rep) >= 3)) new_score = 0; //Claim draw if not winning using draw conditions
+        //Principal variation search: the first move is expected to be best, the others only have to be proven worse
+        //with a null window, a move that turns out better is searched again with the full window for its score
+        PrincipalVariation::Score new_score;
+        if(i == 0) {
+            new_score = -negamaxSearch(thread, depth - 1, -beta, -alpha, ply + 1, true);
+        } else {
+            new_score = -negamaxSearch(thread, depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, true);
+            if(reduction > 0 && new_score > alpha) {
+                //A reduced move beating alpha has to prove it at full depth
+                new_score = -negamaxSearch(thread, depth - 1, -alpha - 1, -alpha, ply + 1, true);
+            }
+            if(new_score > alpha && new_score < beta) {
+                new_score = -negamaxSearch(thread, depth - 1, -beta, -alpha, ply + 1, true);
+            }
+        }
 
         if(new_score > alpha) {
             alpha = new_score;
             best_move = current_move; //Remember potential best move belonging to new_score
-            best_pv = PrincipalVariation::MoveVec(std::get<0>(opponent_score)); //Remember pv that led to the score
+            updatePv(thread, current_move, ply); //Remember pv that led to the score
         }
 
         //UNMAKE MOVE
-        repetition_map[rep]--;
+        board.unmakeMove(current_move, undo);
 
-        if(alpha >= beta) break; //other moves shouldn't be considered (fail-hard beta cutoff)
-    }
-    if(best_move.has_value()) {
-        if(transposition_table.contains(board)) {
-            transposition_table[board] = best_move.value();
+        //An aborted search result is incomplete, it must not end up in the table
+        if(stop_search.load(std::memory_order_relaxed)) return 0;
+
+        if(alpha >= beta) { //other moves shouldn't be considered (fail-hard beta cutoff)
+            if(quiet) updateQuietCutoff(thread, current_move, depth, ply);
+            break;
         }
-        else if(transposition_table.size() < max_transpo_size) {
-            try {
-                transposition_table[board] = best_move.value();
-            } catch(const std::exception& exception) {
-                //Exceptions could be thrown due to limited memory issues if my size constraint fails
-                //Documentation: "If an exception is thrown by any operation, the insertion has no effect" (cppreference)
+    }
+    TranspositionTable::Bound bound = TranspositionTable::Bound::Upper;
+    if(alpha >= beta) bound = TranspositionTable::Bound::Lower;
+    else if(alpha > original_alpha) bound = TranspositionTable::Bound::Exact;
+    transposition_table->store(board.hash(), best_move.value_or(Move()), scoreToTable(alpha, ply), depth, bound);
 
-            }
+    return alpha;
+}
+
+//Whether the position at ply repeats an earlier one, scanning back only as far as a repetition is possible:
+//to the last capture or pawn move (the halfmove counter) and to the last null move
+//Inside the search tree a single repetition is a draw, as the side that could repeat once can repeat again,
+//positions from before the search have to occur three times like in the game
+bool CheessEngine::isRepetition(const SearchThread& thread, unsigned ply) const {
+    unsigned index = thread.game_length + ply;
+    Zobrist::Key key = thread.keys[index];
+    unsigned limit = std::min({static_cast<unsigned>(thread.board.halfMoveCounter()), thread.stack[ply].plies_from_null, index});
+
+    unsigned game_repetitions = 0;
+    for(unsigned distance = 4; distance <= limit; distance += 2) {
+        unsigned previous = index - distance;
+        if(thread.keys[previous] != key) continue;
+        if(previous >= thread.game_length || ++game_repetitions == 2) return true;
+    }
+    return false;
+}
+
+//The pv of a node is its best move followed by the pv its child just left one row further down the table
+void CheessEngine::updatePv(SearchThread& thread, const Move& move, unsigned ply) {
+    auto& row = thread.pv_table[ply];
+    const auto& child_row = thread.pv_table[ply + 1];
+    unsigned child_length = thread.pv_length[ply + 1];
+
+    row[0] = move;
+    std::copy(child_row.begin(), child_row.begin() + child_length, row.begin() + 1);
+    thread.pv_length[ply] = child_length + 1;
+}
+
+//Only captures and promotions are searched, the side to move may also stand pat and keep the static evaluation
+//In check every evasion is searched instead, standing pat could hide a mate
+PrincipalVariation::Score CheessEngine::quiescenceSearch(SearchThread& thread, PrincipalVariation::Score alpha, PrincipalVariation::Score beta, unsigned ply) {
+    Board& board = thread.board;
+    if(visitNode(thread)) return 0;
+    thread.qnodes++;
+
+    bool in_check = board.isPlayerChecked(board.turn());
+    PrincipalVariation::Score stand_pat = 0;
+
+    Board::MoveVec possible_moves;
+    if(in_check) {
+        board.legalMoves(possible_moves);
+        if(possible_moves.empty()) return -mate_score + static_cast<PrincipalVariation::Score>(ply);
+    } else {
+        stand_pat = evalPosition(board);
+        if(stand_pat >= beta) return beta;
+        if(stand_pat > alpha) alpha = stand_pat;
+        board.legalCaptures(possible_moves);
+    }
+    scoreMoves(thread, possible_moves, std::nullopt, ply);
+
+    for(std::size_t i = 0; i < possible_moves.size(); i++) {
+        possible_moves.selectBest(i);
+        const Move current_move = possible_moves[i];
+
+        //Delta pruning: skip captures that cannot raise alpha even with a margin for positional gains
+        if(!in_check && !current_move.isPromotion()) {
+            auto captured = board.piece(current_move.to());
+            PrincipalVariation::Score gain = captured.has_value() ? piece_value.at(captured->type()) : piece_value.at(PieceType::Pawn); //en passant
+            if(stand_pat + gain + delta_margin <= alpha) continue;
+
+            //Captures losing material in the exchange are not worth resolving, their ordering score already says so
+            if(possible_moves.score(i) < 0) continue;
         }
-        best_pv.push_back(best_move.value());
+
+        Board::UndoInfo undo = board.makeMove(current_move);
+        PrincipalVariation::Score score = -quiescenceSearch(thread, -beta, -alpha, ply + 1);
+        board.unmakeMove(current_move, undo);
+
+        if(stop_search.load(std::memory_order_relaxed)) return 0;
+
+        if(score >= beta) return beta; //fail-hard like the main search
+        if(score > alpha) alpha = score;
     }
-    return std::make_tuple(best_pv, alpha);
+    return alpha;
+}
+
+//Counts a node, the main thread watches the clock and stop requests, once an iteration has completed so there always is a move to play
+//Returns true when the search is being abandoned
+bool CheessEngine::visitNode(SearchThread& thread) {
+    thread.nodes++;
+    if(thread.is_main && thread.completed_depth > 0 && thread.nodes % time_check_interval == 0
+       && (stop_requested.load(std::memory_order_relaxed) || time_manager.hardLimitReached())) {
+        stop_search = true;
+    }
+    return stop_search.load(std::memory_order_relaxed);
 }
 
 /**************
@@ -144,28 +439,74 @@ CheessEngine::SearchResult CheessEngine::negamaxSearch(const Board &board, unsig
  *
  * **************/
 
-/*************
- *
- * LEGAL MOVE GENERATION (uses isSquareAttacked and MakeMove)
- *
- * ****************/
+void CheessEngine::scoreMoves(const SearchThread& thread, Board::MoveVec& moves, const std::optional<Move>& tt_move, unsigned ply) const {
+    const Board& board = thread.board;
+    const auto& killers = thread.stack[std::min(ply, max_depth)].killers;
+    const auto& history = thread.history[static_cast<unsigned>(board.turn())];
+
+    for(std::size_t i = 0; i < moves.size(); i++) {
+        const Move& move = moves[i];
+        if(move == tt_move) moves.score(i) = tt_move_order;
+        else if(board.isCapture(move) && !board.seeGe(move, 0)) moves.score(i) = losing_capture_order + captureOrder(board, move) - capture_order;
+        else if(board.isCapture(move) || move.isPromotion()) moves.score(i) = captureOrder(board, move);
+        else if(move == killers[0]) moves.score(i) = killer_order;
+        else if(move == killers[1]) moves.score(i) = killer_order - 1;
+        else moves.score(i) = history[move.fromIndex()][move.toIndex()];
+    }
+}
 
-Board::MoveVec CheessEngine::generateLegalMoves(const Board &board) const {
-    Board::MoveVec moves;
-    board.pseudoLegalMoves(moves);
+//Most valuable victim first, then least valuable attacker, promotions count as capturing the promoted piece
+MoveList::Score CheessEngine::captureOrder(const Board& board, const Move& move) {
+    auto victim = board.piece(move.to());
+    MoveList::Score order = capture_order;
+    if(victim.has_value()) order += 8 * static_cast<MoveList::Score>(victim->type());
+    if(move.isPromotion()) order += 8 * static_cast<MoveList::Score>(move.promotion().value());
+    order -= static_cast<MoveList::Score>(board.piece(move.from())->type());
+    return order; //en passant takes a pawn, which adds nothing
+}
+
+//A quiet move refuting this position is likely to refute its siblings as well
+void CheessEngine::updateQuietCutoff(SearchThread& thread, const Move& move, unsigned depth, unsigned ply) {
+    if(ply <= max_depth) {
+        auto& killers = thread.stack[ply].killers;
+        if(killers[0] != move) {
+            killers[1] = killers[0];
+            killers[0] = move;
+        }
+    }
 
-    auto it = moves.begin();
+    auto& history = thread.history[static_cast<unsigned>(thread.board.turn())];
+    MoveList::Score& entry = history[move.fromIndex()][move.toIndex()];
+    entry += static_cast<MoveList::Score>(depth * depth);
+    if(entry >= history_limit) {
+        for(auto& from : history) {
+            for(auto& score : from) score /= 2;
+        }
+    }
+}
 
-    while(it != moves.end()) {
-        Board copy_board(board);
-        copy_board.makeMove(*it);
-        PieceColor current_turn = board.turn();
-        if(copy_board.isPlayerChecked(current_turn)){
-            it = moves.erase(it);
+//Reductions grow with the logarithms of both the depth and the move's rank in the ordering
+static const auto lmr_reductions = [] {
+    std::array<std::array<unsigned, 64>, 65> table{};
+    for(std::size_t depth = 1; depth < table.size(); depth++) {
+        for(std::size_t index = 1; index < table[depth].size(); index++) {
+            table[depth][index] = static_cast<unsigned>(0.75 + std::log(depth) * std::log(index) / 2.25);
         }
-        else it++;
     }
-    return moves;
+    return table;
+}();
+
+unsigned CheessEngine::lateMoveReduction(unsigned depth, std::size_t move_index) {
+    return lmr_reductions[std::min<std::size_t>(depth, 64)][std::min<std::size_t>(move_index, 63)];
+}
+
+//Zugzwang is common for sides with only pawns, or pawns and a single minor piece that has few useful waiting moves
+//A rook, a queen or two minor pieces almost always have a harmless move to pass with
+bool CheessEngine::hasNullMoveMaterial(const Board& board) {
+    PieceColor turn = board.turn();
+    unsigned minor_pieces = board.getAmountOfPiece(turn, PieceType::Knight) + board.getAmountOfPiece(turn, PieceType::Bishop);
+    unsigned major_pieces = board.getAmountOfPiece(turn, PieceType::Rook) + board.getAmountOfPiece(turn, PieceType::Queen);
+    return major_pieces > 0 || minor_pieces > 1;
 }
 
 /****************
@@ -174,15 +515,6 @@ Board::MoveVec CheessEngine::generateLegalMoves(const Board &board) const {
  *
  * ******************/
 
-const std::map<PieceType, PrincipalVariation::Score> piece_value { //Shannon point values
-        {PieceType::Pawn, 100},
-        {PieceType::Knight, 300},
-        {PieceType::Bishop, 300},
-        {PieceType::Rook, 500},
-        {PieceType::Queen, 900}
-};
-
-
 const PrincipalVariation::Score square_value = 10;
 
 PrincipalVariation::Score CheessEngine::evalPosition(const Board &board) const {
@@ -205,16 +537,15 @@ PrincipalVariation::Score CheessEngine::getMaterialScore(const Board& board) con
 
 PrincipalVariation::Score CheessEngine::getSpaceScore(const Board &board) const {
 
-    std::bitset<64> white_half = 4294967295;
-    std::bitset<64> black_half(white_half);
-    black_half.flip();
+    Bitboard white_half = 4294967295;
+    Bitboard black_half = ~white_half;
 
     auto positions = board.getColorPositions(board.turn());
     auto opponent_positions = board.getColorPositions(!board.turn());
 
-    std::bitset<64> center_mask = 103481868288; //D4/E4/D5/E5
+    Bitboard center_mask = 103481868288; //D4/E4/D5/E5
 
-    PrincipalVariation::Score center_score = ((positions & center_mask).count() * square_value * 5) - ((opponent_positions & center_mask).count() * square_value * 5);
+    PrincipalVariation::Score center_score = (Bitboards::popCount(positions & center_mask) * square_value * 5) - (Bitboards::popCount(opponent_positions & center_mask) * square_value * 5);
 
     switch (board.turn()) {
         case PieceColor::White :
@@ -227,7 +558,7 @@ PrincipalVariation::Score CheessEngine::getSpaceScore(const Board &board) const
             break;
     }
 
-    PrincipalVariation::Score occupation_score = (positions.count() * square_value) - (opponent_positions.count() * square_value);
+    PrincipalVariation::Score occupation_score = (Bitboards::popCount(positions) * square_value) - (Bitboards::popCount(opponent_positions) * square_value);
 
     return center_score + occupation_score;
 }
@@ -239,16 +570,41 @@ PrincipalVariation::Score CheessEngine::getSpaceScore(const Board &board) const
  * *****************/
 
 std::optional<HashInfo> CheessEngine::hashInfo() const {
-    //Only relevant if transposition tables are used
+    //Sizes in MB, like the UCI Hash option
     HashInfo hash_info;
-    hash_info.defaultSize = 2000000000; //2GB
-    hash_info.maxSize = 2000000000;
-    hash_info.minSize = 128000000; //128MB
+    hash_info.defaultSize = default_hash_size;
+    hash_info.maxSize = 65536; //64GB
+    hash_info.minSize = 1;
     return hash_info;
 }
 
 void CheessEngine::setHashSize(std::size_t size) {
-    //Only relevant if transposition tables are used
-    max_transpo_size = size / 40;
+    //Resizing frees the buckets, so an engine sharing its table moves to a table of its own instead
+    if(transposition_table.use_count() == 1) transposition_table->resize(size * bytes_per_megabyte);
+    else transposition_table = std::make_shared<TranspositionTable>(size * bytes_per_megabyte);
+}
+
+std::optional<ThreadsInfo> CheessEngine::threadsInfo() const {
+    ThreadsInfo threads_info;
+    threads_info.defaultCount = 1;
+    threads_info.minCount = 1;
+    threads_info.maxCount = 256;
+    return threads_info;
 }
 
+void CheessEngine::setThreads(std::size_t count) {
+    thread_count = std::max<std::size_t>(count, 1);
+}
+
+//Mate scores are stored relative to the node instead of the root, so they stay valid when reached through another path
+PrincipalVariation::Score CheessEngine::scoreToTable(PrincipalVariation::Score score, unsigned ply) {
+    if(score >= mate_threshold) return score + static_cast<PrincipalVariation::Score>(ply);
+    if(score <= -mate_threshold) return score - static_cast<PrincipalVariation::Score>(ply);
+    return score;
+}
+
+PrincipalVariation::Score CheessEngine::scoreFromTable(PrincipalVariation::Score score, unsigned ply) {
+    if(score >= mate_threshold) return score - static_cast<PrincipalVariation::Score>(ply);
+    if(score <= -mate_threshold) return score + static_cast<PrincipalVariation::Score>(ply);
+    return score;
+}
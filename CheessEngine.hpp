@@ -8,15 +8,34 @@
 #include <memory>
 #include "Engine.hpp"
 #include "Board.hpp"
-#include <unordered_map>
+#include "TranspositionTable.hpp"
+#include "TimeManager.hpp"
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <array>
+#include <optional>
 
 class CheessEngine : public Engine {
 public:
 
-    using SearchResult = std::tuple<PrincipalVariation::MoveVec ,PrincipalVariation::Score>;
+    //Frontier pruning compares the static evaluation against the window with a margin per ply of remaining depth
+    //Each technique is used up to its depth, a depth of 0 disables it
+    struct PruningMargins {
+        unsigned reverse_futility_depth = 6;
+        PrincipalVariation::Score reverse_futility_margin = 120;
+        unsigned futility_depth = 2;
+        PrincipalVariation::Score futility_margin = 150;
+        unsigned razoring_depth = 2;
+        PrincipalVariation::Score razoring_margin = 300;
+    };
 
     CheessEngine();
 
+    //Engines constructed with the same table share their search results, also while searching concurrently
+    //A shared table is never cleared by newGame, setHashSize gives the engine a new table of its own
+    explicit CheessEngine(std::shared_ptr<TranspositionTable> table);
+
     ~CheessEngine() override = default;
 
 
@@ -33,23 +52,142 @@ public:
 
     PrincipalVariation pv(const Board &board, const TimeInfo::Optional &timeInfo) override;
 
+    void setGameHistory(const std::vector<Zobrist::Key>& history) override;
+
+    void stop() override;
+    void clearStop() override;
+
     std::optional<HashInfo> hashInfo() const override;
 
     void setHashSize(std::size_t size) override;
 
+    std::optional<ThreadsInfo> threadsInfo() const override;
+
+    void setThreads(std::size_t count) override;
+
+    //For tuning, takes effect from the next search
+    void setPruningMargins(const PruningMargins& margins);
+
+    //Depth completed by the main thread and nodes visited by all threads, in total and in quiescence search
+    std::optional<SearchInfo> searchInfo() const override;
+
 private:
 
-    //unsigned values are initialized to zero if key doesn't exist yet (by definition)
-    std::unordered_map<Repetition, unsigned, std::hash<Repetition>> repetition_map; //Possible error due to comparison being different than hashed variables?
+    //Keys of the positions of the game before the searched one, oldest first
+    std::vector<Zobrist::Key> game_history;
+
+    std::size_t thread_count = 1;
+
+    PruningMargins pruning_margins;
+
+    SearchInfo search_info{0, 0, 0};
+
+    //Set when time runs out, on a stop request or when the main thread has finished, every thread then abandons its search
+    std::atomic<bool> stop_search = false;
+
+    //Set by stop() from outside until clearStop(), the main thread turns it into stop_search once it has a move to play
+    std::atomic<bool> stop_requested = false;
+
+    TimeManager time_manager;
+
+    //Iterations searched at most when set, the clocks are ignored then
+    std::optional<unsigned> depth_limit;
+
+    static constexpr unsigned max_depth = 64;
+    static constexpr std::size_t max_game_history = 128; //positions, covers the fifty-move rule
+    static constexpr unsigned default_depth = 5; //without time info
+    static constexpr unsigned max_losing_depth = 7; //without time info
+    static constexpr std::uint64_t time_check_interval = 1024; //nodes
+    static constexpr PrincipalVariation::Score delta_margin = 200; //centipawns
+
+    //Null-move pruning searches depth - 1 - (reduction + depth / 4) plies after passing
+    static constexpr unsigned null_move_min_depth = 3;
+    static constexpr unsigned null_move_reduction = 2;
+    static constexpr unsigned null_move_verification_depth = 10;
+
+    //Late move reductions apply from this depth and to moves from this index in the ordering on
+    static constexpr unsigned lmr_min_depth = 3;
+    static constexpr std::size_t lmr_min_move_index = 3;
+
+    static constexpr std::size_t default_hash_size = 64; //MB
+    static constexpr std::size_t bytes_per_megabyte = 1024 * 1024;
+
+    //Score of being mated at the root, a mate n plies away scores n less
+    static constexpr PrincipalVariation::Score mate_score = 100000;
+    static constexpr PrincipalVariation::Score mate_threshold = mate_score - 1000;
+
+    //Bounds of a full window, outside every possible score
+    static constexpr PrincipalVariation::Score infinity_score = mate_score + 1000;
+
+    //Initial half width of the root window around the previous iteration's score
+    static constexpr PrincipalVariation::Score aspiration_window = 50; //centipawns
+
+    //Move ordering: transposition table move, captures and promotions by MVV-LVA, killers, quiet moves by history,
+    //captures losing material according to the static exchange evaluation
+    static constexpr MoveList::Score tt_move_order = 1 << 30;
+    static constexpr MoveList::Score capture_order = 1 << 29;
+    static constexpr MoveList::Score killer_order = 1 << 28;
+    static constexpr MoveList::Score losing_capture_order = -(1 << 28);
+    static constexpr MoveList::Score history_limit = 1 << 20; //history is halved when reaching it, staying below the killers
+
+    //State of one ply of the searched line
+    struct StackEntry {
+        unsigned plies_from_null = 0; //positions before a null move cannot be repeated
+        std::array<Move, 2> killers{}; //quiet moves that caused a beta cutoff at this ply
+    };
+
+    //State owned by one search thread, everything else is shared
+    //Preallocated with fixed sizes, so that searching does not allocate
+    struct SearchThread {
+        Board board;
+        std::uint64_t nodes = 0; //quiescence nodes included
+        std::uint64_t qnodes = 0;
+        unsigned completed_depth = 0;
+        bool is_main = false;
+
+        //Indexed by ply, one entry more than the deepest main search ply
+        std::array<StackEntry, max_depth + 1> stack{};
+
+        //Keys of the end of the game followed by the keys of the searched line, the position at ply is at game_length + ply
+        std::array<Zobrist::Key, max_game_history + max_depth + 1> keys{};
+        unsigned game_length = 0;
+
+        //Quiet moves that caused a beta cutoff per side and from-to squares
+        std::array<std::array<std::array<MoveList::Score, 64>, 64>, 2> history{};
+
+        //Triangular pv table: row ply holds the pv found below ply, filled in place as scores improve
+        std::array<std::array<Move, max_depth + 1>, max_depth + 1> pv_table{};
+        std::array<unsigned, max_depth + 1> pv_length{};
 
-    //transposition table keeping best move of previous iterations
-    std::unordered_map<Board, Move, std::hash<Board>> transposition_table;
+        //Pv and score of the last completed iteration
+        std::array<Move, max_depth + 1> completed_pv{};
+        unsigned completed_length = 0;
+        PrincipalVariation::Score completed_score = 0;
+    };
 
-    size_t max_transpo_size;
+    //results of previous iterations and searches: best move, score, depth and bound
+    std::shared_ptr<TranspositionTable> transposition_table;
 
-    SearchResult negamaxSearch(const Board &board, unsigned depth, PrincipalVariation::Score alpha, PrincipalVariation::Score beta, int turn);
+    void mainSearch(SearchThread& thread);
+    void helperSearch(SearchThread& thread, std::size_t helper_index);
+    static PrincipalVariation completedPv(const SearchThread& thread);
+    bool isRepetition(const SearchThread& thread, unsigned ply) const;
+    PrincipalVariation::Score aspirationSearch(SearchThread& thread, unsigned depth, std::optional<PrincipalVariation::Score> previous_score);
 
-    Board::MoveVec generateLegalMoves(const Board &board) const;
+    PrincipalVariation::Score negamaxSearch(SearchThread& thread, unsigned depth, PrincipalVariation::Score alpha, PrincipalVariation::Score beta, unsigned ply, bool null_move_allowed);
+    PrincipalVariation::Score quiescenceSearch(SearchThread& thread, PrincipalVariation::Score alpha, PrincipalVariation::Score beta, unsigned ply);
+    bool visitNode(SearchThread& thread);
+    static void updatePv(SearchThread& thread, const Move& move, unsigned ply);
+
+    void scoreMoves(const SearchThread& thread, Board::MoveVec& moves, const std::optional<Move>& tt_move, unsigned ply) const;
+    static MoveList::Score captureOrder(const Board& board, const Move& move);
+    static void updateQuietCutoff(SearchThread& thread, const Move& move, unsigned depth, unsigned ply);
+
+    static PrincipalVariation::Score scoreToTable(PrincipalVariation::Score score, unsigned ply);
+    static PrincipalVariation::Score scoreFromTable(PrincipalVariation::Score score, unsigned ply);
+
+    static unsigned lateMoveReduction(unsigned depth, std::size_t move_index);
+    static bool hasNullMoveMaterial(const Board& board);
 
     PrincipalVariation::Score evalPosition(const Board &board) const;
 
@@ -1,7 +1,23 @@
 #include "Engine.hpp"
 
+void Engine::setGameHistory(const std::vector<Zobrist::Key>&) {}
+
+void Engine::stop() {}
+
+void Engine::clearStop() {}
+
 std::optional<HashInfo> Engine::hashInfo() const {
     return std::nullopt;
 }
 
 void Engine::setHashSize(std::size_t) {}
+
+std::optional<ThreadsInfo> Engine::threadsInfo() const {
+    return std::nullopt;
+}
+
+void Engine::setThreads(std::size_t) {}
+
+std::optional<SearchInfo> Engine::searchInfo() const {
+    return std::nullopt;
+}
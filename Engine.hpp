@@ -8,6 +8,8 @@
 #include <string>
 #include <optional>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 struct HashInfo {
     std::size_t defaultSize;
@@ -15,6 +17,19 @@ struct HashInfo {
     std::size_t maxSize;
 };
 
+struct ThreadsInfo {
+    std::size_t defaultCount;
+    std::size_t minCount;
+    std::size_t maxCount;
+};
+
+//Statistics of the last pv() call
+struct SearchInfo {
+    unsigned depth;
+    std::uint64_t nodes;
+    std::uint64_t quiescenceNodes; //part of nodes
+};
+
 class Engine {
 public:
 
@@ -30,8 +45,21 @@ public:
         const TimeInfo::Optional& timeInfo = std::nullopt
     ) = 0;
 
+    //Keys of the positions that occurred in the game before the one passed to pv(), oldest first, for repetitions
+    virtual void setGameHistory(const std::vector<Zobrist::Key>& history);
+
+    //Asks a running pv() call, possibly on another thread, to return its best result so far soon
+    //A stop stays requested until clearStop(), so it also ends a pv() call that had not started yet
+    virtual void stop();
+    virtual void clearStop();
+
     virtual std::optional<HashInfo> hashInfo() const;
     virtual void setHashSize(std::size_t size);
+
+    virtual std::optional<ThreadsInfo> threadsInfo() const;
+    virtual void setThreads(std::size_t count);
+
+    virtual std::optional<SearchInfo> searchInfo() const;
 };
 
 #endif
@@ -2,12 +2,31 @@
 #include "EngineFactory.hpp"
 #include "Fen.hpp"
 #include "Engine.hpp"
+#include "Perft.hpp"
+#include "Bitboard.hpp"
 
 #include <fstream>
 #include <iostream>
 #include <cstdlib>
+#include <string>
+#include <charconv>
+#include <optional>
+
+//A non-negative integer and nothing else, std::stoi would throw on text and accept trailing garbage
+static std::optional<unsigned> parseDepth(const std::string& text) {
+    auto depth = 0u;
+    auto end = text.data() + text.size();
+    auto [rest, error] = std::from_chars(text.data(), end, depth);
+
+    if (error != std::errc() || rest != end) {
+        return std::nullopt;
+    }
+    return depth;
+}
 
 int main(int argc, char* argv[]) {
+    Bitboards::init();
+
     auto engine = EngineFactory::createEngine();
 
     if (engine == nullptr) {
@@ -21,7 +40,31 @@ int main(int argc, char* argv[]) {
      *
      * *************************/
 
-    if (argc > 1) {
+    if (argc > 1 && std::string(argv[1]) == "perft") {
+        //perft <depth> [fen], the FEN may be passed as one argument or as its separate fields
+        auto depth = argc > 2 ? parseDepth(argv[2]) : std::nullopt;
+
+        if (!depth.has_value()) {
+            std::cerr << "Invalid perft depth, expected a non-negative integer\n";
+            std::cerr << "Usage: " << argv[0] << " perft <depth> [fen]\n";
+            return EXIT_FAILURE;
+        }
+
+        auto fen = std::string(argc > 3 ? argv[3] : Fen::StartingPos);
+        for (int i = 4; i < argc; i++) {
+            fen += ' ' + std::string(argv[i]);
+        }
+
+        auto board = Fen::createBoard(fen);
+
+        if (!board.has_value()) {
+            std::cerr << "Parsing FEN failed: " << fen << '\n';
+            std::cerr << "Usage: " << argv[0] << " perft <depth> [fen]\n";
+            return EXIT_FAILURE;
+        }
+
+        Perft::report(board.value(), depth.value(), std::cout);
+    } else if (argc > 1) {
         auto fen = argv[1];
         auto board = Fen::createBoard(fen);
 
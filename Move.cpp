@@ -2,15 +2,6 @@
 
 #include <ostream>
 
-Move::Move(const Square& from, const Square& to,
-           const std::optional<PieceType>& promotion) : from_square{from}, to_square{to}, move_promotion{promotion}
-{
-}
-
-Move::Move() : from_square(Square::A1), to_square(Square::A1) { // Initialized to illegal move (not possible)
-
-}
-
 Move::Optional Move::fromUci(const std::string& uci) {
     if(uci.length() > 5 || uci.length() < 4) return std::nullopt; //Invalid UCI length
     Square::Optional from = Square::fromName(uci.substr(0,2));
@@ -31,27 +22,21 @@ Move::Optional Move::fromUci(const std::string& uci) {
 }
 
 void Move::setFrom(const Square &from) {
-    from_square = from;
+    move_bits = (move_bits & ~Encoding(0x3F)) | from.index();
 }
 
 void Move::setTo(const Square &to) {
-    to_square = to;
+    move_bits = (move_bits & ~Encoding(0x3F << 6)) | (to.index() << 6);
 }
 
 void Move::setPromotion(std::optional<PieceType> promotion) {
-    move_promotion = promotion;
-}
-
-Square Move::from() const {
-    return from_square;
-}
-
-Square Move::to() const {
-    return to_square;
+    Encoding promotion_bits = promotion.has_value() ? static_cast<Encoding>(promotion.value()) : 0;
+    move_bits = (move_bits & 0x0FFF) | (promotion_bits << 12);
 }
 
 std::optional<PieceType> Move::promotion() const {
-    return move_promotion;
+    if(!isPromotion()) return std::nullopt;
+    return static_cast<PieceType>(move_bits >> 12);
 }
 
 std::ostream& operator<<(std::ostream& os, const Move& move) {
@@ -62,11 +47,9 @@ std::ostream& operator<<(std::ostream& os, const Move& move) {
 
 
 bool operator<(const Move& lhs, const Move& rhs) {
-    return (lhs.from().index() + lhs.to().index() + (lhs.promotion().has_value() ? static_cast<unsigned>(lhs.promotion().value()) : 0))
-            <
-             (rhs.from().index() + rhs.to().index() + (rhs.promotion().has_value() ? static_cast<unsigned>(rhs.promotion().value()) : 0));
+    return lhs.encoding() < rhs.encoding();
 }
 
 bool operator==(const Move& lhs, const Move& rhs) {
-    return (lhs.from() == rhs.from() && lhs.to() == rhs.to() && lhs.promotion() == rhs.promotion());
+    return lhs.encoding() == rhs.encoding();
 }
@@ -4,23 +4,28 @@
 #include "Square.hpp"
 #include "Piece.hpp"
 
+#include <cstdint>
 #include <iosfwd>
 #include <optional>
 #include <string>
+#include <type_traits>
 
+//A move packed into 16 bits: bits 0-5 from index, bits 6-11 to index, bits 12-14 promotion type (0 if none)
+//Castling and en passant are not flagged, the board recognizes them from the moved piece
 class Move {
-private:
-    Square from_square;
-    Square to_square;
-    std::optional<PieceType> move_promotion;
-
 public:
 
     using Optional = std::optional<Move>;
+    using Encoding = std::uint16_t;
+
+    //Pawns never promote, so promotion type 0 doubles as "no promotion"
+    constexpr Move(const Square& from, const Square& to,
+                   const std::optional<PieceType>& promotion = std::nullopt)
+        : move_bits{static_cast<Encoding>(from.index() | (to.index() << 6) |
+                                          (promotion.has_value() ? static_cast<unsigned>(promotion.value()) << 12 : 0))} {}
 
-    Move(const Square& from, const Square& to,
-         const std::optional<PieceType>& promotion = std::nullopt);
-    Move();
+    //Trivial so arrays of moves need no setup: Move() is a1a1, an illegal move (not possible), "Move move;" is uninitialized
+    Move() = default;
 
     void setFrom(const Square& from);
     void setTo(const Square& to);
@@ -28,12 +33,46 @@ public:
 
     static Optional fromUci(const std::string& uci);
 
-    Square from() const;
-    Square to() const;
+    //Inverse of encoding(), for compact storage such as the transposition table
+    static constexpr Move fromEncoding(Encoding bits) {
+        Move move;
+        move.move_bits = bits;
+        return move;
+    }
+
+    constexpr Square from() const {
+        return Square::fromIndexUnchecked(fromIndex());
+    }
+
+    constexpr Square to() const {
+        return Square::fromIndexUnchecked(toIndex());
+    }
+
     std::optional<PieceType> promotion() const;
 
+    constexpr Square::Index fromIndex() const {
+        return move_bits & 0x3F;
+    }
+
+    constexpr Square::Index toIndex() const {
+        return (move_bits >> 6) & 0x3F;
+    }
+
+    constexpr bool isPromotion() const {
+        return (move_bits >> 12) != 0;
+    }
+
+    constexpr Encoding encoding() const {
+        return move_bits;
+    }
+
+private:
+    Encoding move_bits;
 };
 
+static_assert(sizeof(Move) == 2);
+static_assert(std::is_trivially_default_constructible_v<Move>);
+
 std::ostream& operator<<(std::ostream& os, const Move& move);
 
 // Needed for std::map, std::set
@@ -0,0 +1,84 @@
+#ifndef CHESS_ENGINE_MOVELIST_HPP
+#define CHESS_ENGINE_MOVELIST_HPP
+
+#include "Move.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+//Fixed capacity move list with inline storage, so generating moves never allocates
+//No legal chess position has more than 218 moves, 256 leaves room for pseudo-legal generation
+//The slots are left uninitialized, only the first size() of them are ever read
+class MoveList {
+public:
+
+    using Score = std::int32_t;
+    using iterator = Move*;
+    using const_iterator = const Move*;
+
+    static constexpr std::size_t capacity = 256;
+
+    void push_back(const Move& move) {
+        assert(count < capacity);
+        moves[count++] = move;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    std::size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    Move& operator[](std::size_t i) {
+        return moves[i];
+    }
+
+    const Move& operator[](std::size_t i) const {
+        return moves[i];
+    }
+
+    iterator begin() { return moves.data(); }
+    iterator end() { return moves.data() + count; }
+    const_iterator begin() const { return moves.data(); }
+    const_iterator end() const { return moves.data() + count; }
+
+    //Ordering score slot belonging to the move at index i, not cleared by push_back
+    Score& score(std::size_t i) {
+        return scores[i];
+    }
+
+    Score score(std::size_t i) const {
+        return scores[i];
+    }
+
+    void swap(std::size_t i, std::size_t j) {
+        std::swap(moves[i], moves[j]);
+        std::swap(scores[i], scores[j]);
+    }
+
+    //Swaps the best scored move from index on into index, so moves can be ordered lazily while searching them
+    void selectBest(std::size_t index) {
+        std::size_t best = index;
+        for(std::size_t i = index + 1; i < count; i++) {
+            if(scores[i] > scores[best]) best = i;
+        }
+        swap(index, best);
+    }
+
+private:
+
+    std::array<Move, capacity> moves;
+    std::array<Score, capacity> scores;
+    std::size_t count = 0;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "Perft.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+
+Perft::NodeCount Perft::perft(Board& board, unsigned depth) {
+    if(depth == 0) return 1;
+
+    Board::MoveVec moves;
+    board.legalMoves(moves);
+
+    //Bulk counting: the moves of the last ply do not have to be made
+    if(depth == 1) return moves.size();
+
+    NodeCount nodes = 0;
+    for(const Move& move : moves) {
+        Board::UndoInfo undo = board.makeMove(move);
+        nodes += perft(board, depth - 1);
+        board.unmakeMove(move, undo);
+    }
+    return nodes;
+}
+
+Perft::Divide Perft::divide(Board& board, unsigned depth) {
+    Divide result;
+    if(depth == 0) return result;
+
+    Board::MoveVec moves;
+    board.legalMoves(moves);
+
+    for(const Move& move : moves) {
+        Board::UndoInfo undo = board.makeMove(move);
+        result.emplace_back(move, perft(board, depth - 1));
+        board.unmakeMove(move, undo);
+    }
+    return result;
+}
+
+Perft::NodeCount Perft::report(const Board& board, unsigned depth, std::ostream& os) {
+    Board perft_board(board);
+
+    auto start = std::chrono::steady_clock::now();
+    Divide moves = divide(perft_board, depth);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    NodeCount total = depth == 0 ? 1 : 0;
+    for(const auto& [move, nodes] : moves) {
+        os << move << ": " << nodes << '\n';
+        total += nodes;
+    }
+
+    //Avoid dividing by zero for very fast runs
+    auto nps = total * 1000000 / std::max<std::chrono::microseconds::rep>(elapsed.count(), 1);
+
+    os << '\n'
+       << "Nodes searched: " << total << '\n'
+       << "Time: " << elapsed.count() / 1000 << " ms\n"
+       << "Nodes/second: " << nps << '\n';
+    return total;
+}
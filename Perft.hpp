@@ -0,0 +1,26 @@
+#ifndef CHESS_ENGINE_PERFT_HPP
+#define CHESS_ENGINE_PERFT_HPP
+
+#include "Board.hpp"
+#include "Move.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+//Counts the leaf nodes of the legal move tree, the standard move generation correctness check and benchmark
+namespace Perft {
+    using NodeCount = std::uint64_t;
+    using Divide = std::vector<std::pair<Move, NodeCount>>;
+
+    NodeCount perft(Board& board, unsigned depth);
+
+    //Node count below every legal root move
+    Divide divide(Board& board, unsigned depth);
+
+    //Writes the divide, the total node count, the elapsed time and the nodes per second, returns the total
+    NodeCount report(const Board& board, unsigned depth, std::ostream& os);
+}
+
+#endif
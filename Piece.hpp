@@ -3,13 +3,14 @@
 
 #include <optional>
 #include <iosfwd>
+#include <cstdint>
 
-enum class PieceColor {
+enum class PieceColor : std::uint8_t {
     White,
     Black
 };
 
-enum class PieceType {
+enum class PieceType : std::uint8_t {
     Pawn,
     Knight,
     Bishop,
@@ -1,9 +1,10 @@
 #include "PrincipalVariation.hpp"
 
 #include <ostream>
+#include <utility>
 
 
-PrincipalVariation::PrincipalVariation(PrincipalVariation::MoveVec &&moves, int32_t score, bool mate) : moves{moves}, eval_score{score}, mate{mate} {
+PrincipalVariation::PrincipalVariation(PrincipalVariation::MoveVec &&moves, int32_t score, bool mate) : moves{std::move(moves)}, eval_score{score}, mate{mate} {
 }
 
 bool PrincipalVariation::isMate() const {
@@ -4,7 +4,10 @@
 #include <optional>
 #include <iosfwd>
 #include <string>
+#include <cstdint>
+#include <functional>
 
+//A square stored as its index in one byte, file and rank are computed from it
 class Square {
 public:
 
@@ -12,13 +15,38 @@ public:
     using Index = unsigned;
     using Optional = std::optional<Square>;
 
-    static Optional fromCoordinates(Coordinate file, Coordinate rank);
-    static Optional fromIndex(Index index);
+    static constexpr Optional fromCoordinates(Coordinate file, Coordinate rank) {
+        if(file > 7 || rank > 7) return std::nullopt;
+        return fromCoordinatesUnchecked(file, rank);
+    }
+
+    static constexpr Optional fromIndex(Index index) {
+        if(index > 63) return std::nullopt;
+        return fromIndexUnchecked(index);
+    }
+
     static Optional fromName(const std::string& name);
 
-    Coordinate file() const;
-    Coordinate rank() const;
-    Index index() const;
+    //No range checks, for internal code that already knows the square is on the board
+    static constexpr Square fromIndexUnchecked(Index index) {
+        return Square(index);
+    }
+
+    static constexpr Square fromCoordinatesUnchecked(Coordinate file, Coordinate rank) {
+        return Square(rank * 8 + file);
+    }
+
+    constexpr Coordinate file() const {
+        return square_index % 8;
+    }
+
+    constexpr Coordinate rank() const {
+        return square_index / 8;
+    }
+
+    constexpr Index index() const {
+        return square_index;
+    }
 
     static const Square A1, B1, C1, D1, E1, F1, G1, H1;
     static const Square A2, B2, C2, D2, E2, F2, G2, H2;
@@ -30,27 +58,102 @@ public:
     static const Square A8, B8, C8, D8, E8, F8, G8, H8;
 
 private:
-    Coordinate square_file;
-    Coordinate square_rank;
-    Index square_index;
+    std::uint8_t square_index;
 
-    Square(Index index);
+    constexpr explicit Square(Index index) : square_index{static_cast<std::uint8_t>(index)} {}
 };
 
+static_assert(sizeof(Square) == 1);
+
+inline constexpr Square Square::A1 = Square::fromIndexUnchecked( 0 + 0);
+inline constexpr Square Square::B1 = Square::fromIndexUnchecked( 0 + 1);
+inline constexpr Square Square::C1 = Square::fromIndexUnchecked( 0 + 2);
+inline constexpr Square Square::D1 = Square::fromIndexUnchecked( 0 + 3);
+inline constexpr Square Square::E1 = Square::fromIndexUnchecked( 0 + 4);
+inline constexpr Square Square::F1 = Square::fromIndexUnchecked( 0 + 5);
+inline constexpr Square Square::G1 = Square::fromIndexUnchecked( 0 + 6);
+inline constexpr Square Square::H1 = Square::fromIndexUnchecked( 0 + 7);
+
+inline constexpr Square Square::A2 = Square::fromIndexUnchecked( 8 + 0);
+inline constexpr Square Square::B2 = Square::fromIndexUnchecked( 8 + 1);
+inline constexpr Square Square::C2 = Square::fromIndexUnchecked( 8 + 2);
+inline constexpr Square Square::D2 = Square::fromIndexUnchecked( 8 + 3);
+inline constexpr Square Square::E2 = Square::fromIndexUnchecked( 8 + 4);
+inline constexpr Square Square::F2 = Square::fromIndexUnchecked( 8 + 5);
+inline constexpr Square Square::G2 = Square::fromIndexUnchecked( 8 + 6);
+inline constexpr Square Square::H2 = Square::fromIndexUnchecked( 8 + 7);
+
+inline constexpr Square Square::A3 = Square::fromIndexUnchecked(16 + 0);
+inline constexpr Square Square::B3 = Square::fromIndexUnchecked(16 + 1);
+inline constexpr Square Square::C3 = Square::fromIndexUnchecked(16 + 2);
+inline constexpr Square Square::D3 = Square::fromIndexUnchecked(16 + 3);
+inline constexpr Square Square::E3 = Square::fromIndexUnchecked(16 + 4);
+inline constexpr Square Square::F3 = Square::fromIndexUnchecked(16 + 5);
+inline constexpr Square Square::G3 = Square::fromIndexUnchecked(16 + 6);
+inline constexpr Square Square::H3 = Square::fromIndexUnchecked(16 + 7);
+
+inline constexpr Square Square::A4 = Square::fromIndexUnchecked(24 + 0);
+inline constexpr Square Square::B4 = Square::fromIndexUnchecked(24 + 1);
+inline constexpr Square Square::C4 = Square::fromIndexUnchecked(24 + 2);
+inline constexpr Square Square::D4 = Square::fromIndexUnchecked(24 + 3);
+inline constexpr Square Square::E4 = Square::fromIndexUnchecked(24 + 4);
+inline constexpr Square Square::F4 = Square::fromIndexUnchecked(24 + 5);
+inline constexpr Square Square::G4 = Square::fromIndexUnchecked(24 + 6);
+inline constexpr Square Square::H4 = Square::fromIndexUnchecked(24 + 7);
+
+inline constexpr Square Square::A5 = Square::fromIndexUnchecked(32 + 0);
+inline constexpr Square Square::B5 = Square::fromIndexUnchecked(32 + 1);
+inline constexpr Square Square::C5 = Square::fromIndexUnchecked(32 + 2);
+inline constexpr Square Square::D5 = Square::fromIndexUnchecked(32 + 3);
+inline constexpr Square Square::E5 = Square::fromIndexUnchecked(32 + 4);
+inline constexpr Square Square::F5 = Square::fromIndexUnchecked(32 + 5);
+inline constexpr Square Square::G5 = Square::fromIndexUnchecked(32 + 6);
+inline constexpr Square Square::H5 = Square::fromIndexUnchecked(32 + 7);
+
+inline constexpr Square Square::A6 = Square::fromIndexUnchecked(40 + 0);
+inline constexpr Square Square::B6 = Square::fromIndexUnchecked(40 + 1);
+inline constexpr Square Square::C6 = Square::fromIndexUnchecked(40 + 2);
+inline constexpr Square Square::D6 = Square::fromIndexUnchecked(40 + 3);
+inline constexpr Square Square::E6 = Square::fromIndexUnchecked(40 + 4);
+inline constexpr Square Square::F6 = Square::fromIndexUnchecked(40 + 5);
+inline constexpr Square Square::G6 = Square::fromIndexUnchecked(40 + 6);
+inline constexpr Square Square::H6 = Square::fromIndexUnchecked(40 + 7);
+
+inline constexpr Square Square::A7 = Square::fromIndexUnchecked(48 + 0);
+inline constexpr Square Square::B7 = Square::fromIndexUnchecked(48 + 1);
+inline constexpr Square Square::C7 = Square::fromIndexUnchecked(48 + 2);
+inline constexpr Square Square::D7 = Square::fromIndexUnchecked(48 + 3);
+inline constexpr Square Square::E7 = Square::fromIndexUnchecked(48 + 4);
+inline constexpr Square Square::F7 = Square::fromIndexUnchecked(48 + 5);
+inline constexpr Square Square::G7 = Square::fromIndexUnchecked(48 + 6);
+inline constexpr Square Square::H7 = Square::fromIndexUnchecked(48 + 7);
+
+inline constexpr Square Square::A8 = Square::fromIndexUnchecked(56 + 0);
+inline constexpr Square Square::B8 = Square::fromIndexUnchecked(56 + 1);
+inline constexpr Square Square::C8 = Square::fromIndexUnchecked(56 + 2);
+inline constexpr Square Square::D8 = Square::fromIndexUnchecked(56 + 3);
+inline constexpr Square Square::E8 = Square::fromIndexUnchecked(56 + 4);
+inline constexpr Square Square::F8 = Square::fromIndexUnchecked(56 + 5);
+inline constexpr Square Square::G8 = Square::fromIndexUnchecked(56 + 6);
+inline constexpr Square Square::H8 = Square::fromIndexUnchecked(56 + 7);
+
 template<>
 struct std::hash<Square>
 {
     std::size_t operator()(const Square& square) const {
-        return (std::hash<Square::Index>{}(square.index()) ^
-        std::hash<Square::Coordinate>{}(square.file()) ^
-        std::hash<Square::Coordinate>{}(square.rank()));
+        return std::hash<Square::Index>{}(square.index());
     }
 };
 
 std::ostream& operator<<(std::ostream& os, const Square& square);
 
 // Necessary to support Square as the key in std::map.
-bool operator<(const Square& lhs, const Square& rhs);
-bool operator==(const Square& lhs, const Square& rhs);
+constexpr bool operator<(const Square& lhs, const Square& rhs) {
+    return lhs.index() < rhs.index();
+}
+
+constexpr bool operator==(const Square& lhs, const Square& rhs) {
+    return lhs.index() == rhs.index();
+}
 
 #endif
@@ -0,0 +1,168 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "EngineFactory.hpp"
+#include "Engine.hpp"
+#include "Fen.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+//Every global operator new and delete of this executable is replaced, so tests can count the allocations
+//The replacements live in their own test executable, the other tests keep the allocator sanitizers hook into
+static std::atomic<std::size_t> allocation_count = 0;
+
+static void* allocate(std::size_t size, std::size_t alignment) {
+    allocation_count++;
+    size = size == 0 ? 1 : size;
+    if(alignment <= alignof(std::max_align_t)) return std::malloc(size);
+#ifdef _MSC_VER
+    return _aligned_malloc(size, alignment);
+#else
+    //aligned_alloc needs a size that is a multiple of the alignment
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void deallocate(void* memory, std::size_t alignment) noexcept {
+#ifdef _MSC_VER
+    if(alignment > alignof(std::max_align_t)) {
+        _aligned_free(memory);
+        return;
+    }
+#endif
+    (void)alignment;
+    std::free(memory);
+}
+
+static void* allocateOrThrow(std::size_t size, std::size_t alignment) {
+    if(void* memory = allocate(size, alignment)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size) {
+    return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return allocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory) noexcept {
+    deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::align_val_t alignment) noexcept {
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment) noexcept {
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    deallocate(memory, alignof(std::max_align_t));
+}
+
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    deallocate(memory, static_cast<std::size_t>(alignment));
+}
+
+TEST_CASE("Every kind of allocation is counted", "[Allocation]") {
+    struct alignas(64) CacheLine {
+        char bytes[64];
+    };
+
+    auto before = allocation_count.load();
+    delete new int(1);
+    delete[] new int[4];
+    delete new CacheLine();
+    delete[] new CacheLine[4];
+    auto aligned = std::make_unique<CacheLine[]>(2);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(aligned.get()) % 64 == 0);
+
+    REQUIRE(allocation_count.load() - before == 5);
+}
+
+TEST_CASE("Searching does not allocate after warm-up", "[Engine][Allocation]") {
+    auto engine = EngineFactory::createEngine();
+    REQUIRE(engine != nullptr);
+
+    auto fen = GENERATE(
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"
+    );
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo = {};
+    timeInfo.depth = 6;
+
+    engine->pv(board.value(), timeInfo);
+
+    auto before = allocation_count.load();
+    auto pv = engine->pv(board.value(), timeInfo);
+    auto allocations = allocation_count.load() - before;
+
+    CAPTURE(fen);
+    REQUIRE(pv.length() > 0);
+    //Only the moves of the returned principal variation
+    REQUIRE(allocations <= 1);
+}
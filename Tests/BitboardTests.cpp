@@ -0,0 +1,88 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "Bitboard.hpp"
+
+#include <vector>
+
+static Bitboard bitsOf(const std::vector<Square>& squares) {
+    Bitboard bb = 0;
+    for (auto square : squares) {
+        bb |= Bitboards::squareBit(square.index());
+    }
+    return bb;
+}
+
+TEST_CASE("Bitboards iterate their set bits in index order", "[Bitboard][Fundamental]") {
+    auto bb = bitsOf({Square::A1, Square::E4, Square::H8});
+    REQUIRE(Bitboards::popCount(bb) == 3);
+
+    auto indices = std::vector<Square::Index>();
+    while (bb) {
+        indices.push_back(Bitboards::popLsb(bb));
+    }
+
+    REQUIRE(indices == std::vector<Square::Index>{0, 28, 63});
+}
+
+TEST_CASE("Knight attack tables do not wrap around the board", "[Bitboard][Knight]") {
+    REQUIRE(Bitboards::knight_attacks[Square::A1.index()] == bitsOf({Square::B3, Square::C2}));
+    REQUIRE(Bitboards::knight_attacks[Square::H5.index()] ==
+            bitsOf({Square::G7, Square::F6, Square::F4, Square::G3}));
+    REQUIRE(Bitboards::popCount(Bitboards::knight_attacks[Square::D4.index()]) == 8);
+}
+
+TEST_CASE("King attack tables do not wrap around the board", "[Bitboard][King]") {
+    REQUIRE(Bitboards::king_attacks[Square::H1.index()] == bitsOf({Square::G1, Square::G2, Square::H2}));
+    REQUIRE(Bitboards::king_attacks[Square::A5.index()] ==
+            bitsOf({Square::A6, Square::B6, Square::B5, Square::B4, Square::A4}));
+}
+
+TEST_CASE("Pawn attack tables depend on the pawn color", "[Bitboard][Pawn]") {
+    REQUIRE(Bitboards::pawnAttacks(PieceColor::White, Square::A2.index()) == bitsOf({Square::B3}));
+    REQUIRE(Bitboards::pawnAttacks(PieceColor::White, Square::E4.index()) == bitsOf({Square::D5, Square::F5}));
+    REQUIRE(Bitboards::pawnAttacks(PieceColor::Black, Square::H7.index()) == bitsOf({Square::G6}));
+    REQUIRE(Bitboards::pawnAttacks(PieceColor::Black, Square::E4.index()) == bitsOf({Square::D3, Square::F3}));
+}
+
+TEST_CASE("Sliding attack lookups match walking the rays", "[Bitboard][Sliding]") {
+    auto occupied = GENERATE(as<Bitboard>{},
+        0x0000000000000000ULL,
+        0xFFFF00000000FFFFULL,
+        0x0042240018244200ULL,
+        0x8100A5003C00A581ULL,
+        0x123456789ABCDEF0ULL
+    );
+
+    for (Square::Index index = 0; index < 64; ++index) {
+        CAPTURE(index, occupied);
+        REQUIRE(Bitboards::rookAttacks(index, occupied) ==
+                Bitboards::slidingAttacks(index, occupied, Bitboards::rook_deltas));
+        REQUIRE(Bitboards::bishopAttacks(index, occupied) ==
+                Bitboards::slidingAttacks(index, occupied, Bitboards::bishop_deltas));
+    }
+}
+
+TEST_CASE("Rook attacks stop at the first blocker", "[Bitboard][Sliding]") {
+    auto occupied = bitsOf({Square::D6, Square::B4, Square::D2});
+    auto expected = bitsOf({
+        Square::D5, Square::D6,
+        Square::D3, Square::D2,
+        Square::C4, Square::B4,
+        Square::E4, Square::F4, Square::G4, Square::H4
+    });
+
+    REQUIRE(Bitboards::rookAttacks(Square::D4.index(), occupied) == expected);
+}
+
+TEST_CASE("Initializing the tables again keeps them intact", "[Bitboard][Sliding]") {
+    auto occupied = bitsOf({Square::D2, Square::F4, Square::D7});
+
+    Bitboards::init();
+
+    REQUIRE(Bitboards::rookAttacks(Square::D4.index(), occupied) ==
+            Bitboards::slidingAttacks(Square::D4.index(), occupied, Bitboards::rook_deltas));
+    REQUIRE(Bitboards::bishopAttacks(Square::D4.index(), occupied) ==
+            Bitboards::slidingAttacks(Square::D4.index(), occupied, Bitboards::bishop_deltas));
+}
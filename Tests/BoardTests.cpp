@@ -50,6 +50,14 @@ TEST_CASE("Pieces can be set on a board", "[Board][Fundamental]") {
         auto newSetPiece = optNewSetPiece.value();
         REQUIRE(newSetPiece == newPiece);
     }
+
+    SECTION("Setting an empty piece clears the square") {
+        board.setPiece(square, std::nullopt);
+
+        REQUIRE_FALSE(board.piece(square).has_value());
+        REQUIRE(board.piecePositions() == PiecePositions());
+        REQUIRE(board.hash() == Board().hash());
+    }
 }
 
 TEST_CASE("The turn can be set on a board", "[Board][Fundamental]") {
@@ -943,3 +951,344 @@ TEST_CASE_PSEUDO_MOVES("Pseudo-legal moves, multiple pieces, black", "") {
         }
     );
 }
+
+static void testHashAfterMoves(const char* fen,
+                               const std::vector<std::string>& uciMoves,
+                               const char* expectedFen) {
+    CAPTURE(fen, expectedFen);
+
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+
+    for (const auto& uciMove : uciMoves) {
+        auto move = Move::fromUci(uciMove);
+        REQUIRE(move.has_value());
+        board->makeMove(move.value());
+    }
+
+    auto expectedBoard = Fen::createBoard(expectedFen);
+    REQUIRE(expectedBoard.has_value());
+    REQUIRE(board->hash() == expectedBoard->hash());
+}
+
+#define TEST_CASE_HASH(name, tag) \
+    TEST_CASE(name, "[Board][Hash]" tag)
+
+TEST_CASE_HASH("Hash is updated by quiet moves and captures", "") {
+    testHashAfterMoves(
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        {"g1f3", "d7d5", "f3e5", "d5d4", "e5f7"},
+        "rnbqkbnr/ppp1pNpp/8/8/3p4/8/PPPPPPPP/RNBQKB1R b KQkq - 0 3"
+    );
+}
+
+TEST_CASE_HASH("Hash is updated by castling and lost castling rights", "[Castling]") {
+    testHashAfterMoves(
+        "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1",
+        {"e1g1", "a8a7"},
+        "4k2r/r7/8/8/8/8/8/R4RK1 w k - 2 2"
+    );
+}
+
+TEST_CASE_HASH("Hash is updated by en passant", "[EnPassant]") {
+    testHashAfterMoves(
+        "4k3/8/8/8/3p4/8/4P3/4K3 w - - 0 1",
+        {"e2e4"},
+        "4k3/8/8/8/3pP3/8/8/4K3 b - e3 0 1"
+    );
+    testHashAfterMoves(
+        "4k3/8/8/8/3p4/8/4P3/4K3 w - - 0 1",
+        {"e2e4", "d4e3"},
+        "4k3/8/8/8/8/4p3/8/4K3 w - - 0 2"
+    );
+}
+
+TEST_CASE_HASH("Hash is updated by promotions", "[Promotion]") {
+    testHashAfterMoves(
+        "1n2k3/P7/8/8/8/8/8/4K3 w - - 0 1",
+        {"a7b8n"},
+        "1N2k3/8/8/8/8/8/8/4K3 b - - 0 1"
+    );
+}
+
+TEST_CASE_HASH("Hash ignores the halfmove counter", "") {
+    auto board1 = Fen::createBoard("4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    auto board2 = Fen::createBoard("4k3/8/8/8/8/8/8/R3K3 w - - 37 60");
+    REQUIRE(board1.has_value());
+    REQUIRE(board2.has_value());
+    REQUIRE(board1->hash() == board2->hash());
+
+    auto board3 = Fen::createBoard("4k3/8/8/8/8/8/8/R3K3 b - - 0 1");
+    REQUIRE(board3.has_value());
+    REQUIRE_FALSE(board1->hash() == board3->hash());
+}
+
+TEST_CASE("Unmaking a move restores the board", "[Board][MoveMaking]") {
+    auto fen = GENERATE(
+        // https://lichess.org/editor/r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R_w_KQkq_-_0_1
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        // https://lichess.org/editor/r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1_b_kq_-_0_1
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 b kq - 0 1",
+        // https://lichess.org/editor/8/8/8/3pPp2/8/8/8/4K2k_w_-_d6_0_1
+        "8/8/8/3pPp2/8/8/8/4K2k w - d6 0 1"
+    );
+
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+
+    auto original = board.value();
+    auto moves = Board::MoveVec();
+    board->pseudoLegalMoves(moves);
+
+    for (const auto& move : moves) {
+        CAPTURE(fen, move);
+        auto undo = board->makeMove(move);
+        board->unmakeMove(move, undo);
+
+        REQUIRE(board.value() == original);
+        REQUIRE(board->halfMoveCounter() == original.halfMoveCounter());
+        REQUIRE(board->hash() == original.hash());
+    }
+}
+
+TEST_CASE("Null moves pass the turn and clear en passant", "[Board][MoveMaking]") {
+    // https://lichess.org/editor/4k3/8/8/3pP3/8/8/8/4K3_w_-_d6_0_1
+    auto board = Fen::createBoard("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    REQUIRE(board.has_value());
+    auto passed = Fen::createBoard("4k3/8/8/3pP3/8/8/8/4K3 b - - 1 1");
+    REQUIRE(passed.has_value());
+
+    auto original = board.value();
+    auto undo = board->makeNullMove();
+
+    REQUIRE(board.value() == passed.value());
+    REQUIRE(board->hash() == passed->hash());
+    REQUIRE(board->halfMoveCounter() == 1);
+
+    board->unmakeNullMove(undo);
+
+    REQUIRE(board.value() == original);
+    REQUIRE(board->hash() == original.hash());
+    REQUIRE(board->halfMoveCounter() == original.halfMoveCounter());
+}
+
+static void testLegalMoves(const char* fen, const std::vector<std::string>& expectedUcis,
+                           bool capturesOnly = false) {
+    auto optBoard = Fen::createBoard(fen);
+    REQUIRE(optBoard.has_value());
+    auto board = optBoard.value();
+
+    using MoveSet = std::set<Move>;
+    auto expectedMoves = MoveSet();
+
+    for (const auto& uci : expectedUcis) {
+        auto optMove = Move::fromUci(uci);
+        REQUIRE(optMove.has_value());
+        expectedMoves.insert(optMove.value());
+    }
+
+    auto generatedMovesVec = Board::MoveVec();
+    if (capturesOnly) {
+        board.legalCaptures(generatedMovesVec);
+    } else {
+        board.legalMoves(generatedMovesVec);
+    }
+    auto generatedMoves = MoveSet(generatedMovesVec.begin(),
+                                  generatedMovesVec.end());
+
+    CAPTURE(fen, generatedMoves, expectedMoves);
+    REQUIRE(generatedMovesVec.size() == generatedMoves.size());
+    REQUIRE(generatedMoves == expectedMoves);
+}
+
+#define TEST_CASE_LEGAL_MOVES(name, tag) \
+    TEST_CASE(name, "[Board][MoveGen][Legal]" tag)
+
+TEST_CASE_LEGAL_MOVES("Legal moves, pinned piece cannot leave the pin line", "[Pin]") {
+    // https://lichess.org/editor/4k3/8/8/8/4r3/8/4B3/4K3_w_-_-_0_1
+    testLegalMoves(
+        "4k3/8/8/8/4r3/8/4B3/4K3 w - - 0 1",
+        {"e1d1", "e1f1", "e1d2", "e1f2"}
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal moves, pinned piece moves along the pin line", "[Pin]") {
+    // https://lichess.org/editor/4k3/8/8/8/4r3/8/4R3/4K3_w_-_-_0_1
+    testLegalMoves(
+        "4k3/8/8/8/4r3/8/4R3/4K3 w - - 0 1",
+        {"e1d1", "e1f1", "e1d2", "e1f2", "e2e3", "e2e4"}
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal moves, en passant exposing the king", "[EnPassant][Pin]") {
+    // https://lichess.org/editor/8/8/8/KPp4r/8/8/8/7k_w_-_c6_0_1
+    testLegalMoves(
+        "8/8/8/KPp4r/8/8/8/7k w - c6 0 1",
+        {"a5a4", "a5a6", "a5b6", "b5b6"}
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal moves, check evasions", "[Check]") {
+    // https://lichess.org/editor/4k3/8/8/8/8/8/3N4/r3K3_w_-_-_0_1
+    testLegalMoves(
+        "4k3/8/8/8/8/8/3N4/r3K3 w - - 0 1",
+        {"e1e2", "e1f2", "d2b1"}
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal moves, double check only allows king moves", "[Check]") {
+    // https://lichess.org/editor/4k3/8/8/8/8/5n2/3B4/r3K3_w_-_-_0_1
+    testLegalMoves(
+        "4k3/8/8/8/8/5n2/3B4/r3K3 w - - 0 1",
+        {"e1e2", "e1f2"}
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal captures, captures and promotions only", "[Capture][Promotion]") {
+    // https://lichess.org/editor/1n2k3/P7/8/3p4/4P3/8/8/4K3_w_-_-_0_1
+    testLegalMoves(
+        "1n2k3/P7/8/3p4/4P3/8/8/4K3 w - - 0 1",
+        {"e4d5", "a7a8q", "a7a8r", "a7a8b", "a7a8n", "a7b8q", "a7b8r", "a7b8b", "a7b8n"},
+        true
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal captures, en passant", "[Capture][EnPassant]") {
+    // https://lichess.org/editor/4k3/8/8/3pP3/8/8/8/4K3_w_-_d6_0_1
+    testLegalMoves(
+        "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1",
+        {"e5d6"},
+        true
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal captures, check evasions", "[Capture][Check]") {
+    // https://lichess.org/editor/4k3/8/8/8/8/8/3N4/r3K3_w_-_-_0_1
+    testLegalMoves(
+        "4k3/8/8/8/8/8/3N4/r3K3 w - - 0 1",
+        {},
+        true
+    );
+}
+
+TEST_CASE_LEGAL_MOVES("Legal captures, pinned piece", "[Capture][Pin]") {
+    // https://lichess.org/editor/4k3/8/8/4r3/8/2p1R3/8/4K3_w_-_-_0_1
+    testLegalMoves(
+        "4k3/8/8/4r3/8/2p1R3/8/4K3 w - - 0 1",
+        {"e3e5"},
+        true
+    );
+}
+
+TEST_CASE("Single moves are legal exactly when they are generated", "[Board][MoveGen][Legal]") {
+    auto fen = GENERATE(
+        // https://lichess.org/editor/r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R_w_KQkq_-_0_1
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        // https://lichess.org/editor/8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8_w_-_-_0_1
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        // https://lichess.org/editor/r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1_w_kq_-_0_1
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        // https://lichess.org/editor/4k3/8/8/K2pP2r/8/8/8/8_w_-_d6_0_1
+        "4k3/8/8/K2pP2r/8/8/8/8 w - d6 0 1",
+        // https://lichess.org/editor/4k3/8/8/8/8/8/3N4/r3K3_w_-_-_0_1
+        "4k3/8/8/8/8/8/3N4/r3K3 w - - 0 1",
+        // https://lichess.org/editor/4k3/8/8/8/1b6/8/3N4/r3K3_w_-_-_0_1
+        "4k3/8/8/8/1b6/8/3N4/r3K3 w - - 0 1"
+    );
+
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+
+    auto legalMoves = Board::MoveVec();
+    board->legalMoves(legalMoves);
+
+    CAPTURE(fen);
+    for (auto from = 0; from < 64; from++) {
+        for (auto to = 0; to < 64; to++) {
+            for (auto promotion : {std::optional<PieceType>(), std::optional<PieceType>(PieceType::Queen)}) {
+                auto move = Move(Square::fromIndex(from).value(), Square::fromIndex(to).value(), promotion);
+                auto generated = std::find(legalMoves.begin(), legalMoves.end(), move) != legalMoves.end();
+
+                CAPTURE(move);
+                REQUIRE(board->isLegal(move) == generated);
+            }
+        }
+    }
+}
+
+static void testSee(const char* fen, const char* uci, int expected) {
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+    auto move = Move::fromUci(uci);
+    REQUIRE(move.has_value());
+
+    CAPTURE(fen, uci);
+    REQUIRE(board->see(move.value()) == expected);
+    REQUIRE(board->seeGe(move.value(), expected));
+    REQUIRE_FALSE(board->seeGe(move.value(), expected + 1));
+}
+
+#define TEST_CASE_SEE(name, tag) \
+    TEST_CASE(name, "[Board][See]" tag)
+
+TEST_CASE_SEE("Static exchange, undefended pawn", "") {
+    // https://lichess.org/editor/1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3_w_-_-_0_1
+    testSee("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "e1e5", 100);
+}
+
+TEST_CASE_SEE("Static exchange, x-ray attackers", "") {
+    // https://lichess.org/editor/1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3_w_-_-_0_1
+    testSee("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "d3e5", -200);
+}
+
+TEST_CASE_SEE("Static exchange, defended piece taken by a pawn", "") {
+    // https://lichess.org/editor/4k3/8/3r4/2P5/8/8/8/3RK3_w_-_-_0_1
+    testSee("4k3/8/3r4/2P5/8/8/8/3RK3 w - - 0 1", "c5d6", 500);
+}
+
+TEST_CASE_SEE("Static exchange, queen taking a defended pawn", "") {
+    // https://lichess.org/editor/4k3/2p5/3p4/8/8/8/8/3QK3_w_-_-_0_1
+    testSee("4k3/2p5/3p4/8/8/8/8/3QK3 w - - 0 1", "d1d6", -800);
+}
+
+TEST_CASE_SEE("Static exchange, king cannot recapture a defended piece", "") {
+    // https://lichess.org/editor/1R6/8/8/8/8/2k5/1p6/1R2K3_w_-_-_0_1
+    testSee("1R6/8/8/8/8/2k5/1p6/1R2K3 w - - 0 1", "b1b2", 100);
+}
+
+TEST_CASE_SEE("Static exchange, king recaptures an undefended piece", "") {
+    // https://lichess.org/editor/8/8/8/8/8/2k5/1p6/RR2K3_w_-_-_0_1
+    testSee("8/8/8/8/8/2k5/1p6/RR2K3 w - - 0 1", "b1b2", -400);
+}
+
+TEST_CASE_SEE("Static exchange, en passant", "[EnPassant]") {
+    // https://lichess.org/editor/4k3/8/8/3pP3/8/8/8/4K3_w_-_d6_0_1
+    testSee("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6", 100);
+}
+
+TEST_CASE_SEE("Static exchange threshold agrees with the full exchange", "") {
+    auto fen = GENERATE(
+        // https://lichess.org/editor/r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R_w_KQkq_-_0_1
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        // https://lichess.org/editor/1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3_w_-_-_0_1
+        "1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1",
+        // https://lichess.org/editor/rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R_w_KQ_-_1_8
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"
+    );
+
+    CAPTURE(fen);
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+
+    auto captures = Board::MoveVec();
+    board->legalCaptures(captures);
+    REQUIRE(captures.size() > 0);
+
+    for(auto move : captures) {
+        auto see = board->see(move);
+        for(auto threshold = -1000; threshold <= 1000; threshold += 50) {
+            CAPTURE(move, threshold);
+            REQUIRE(board->seeGe(move, threshold) == (see >= threshold));
+        }
+    }
+}
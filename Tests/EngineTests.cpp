@@ -6,6 +6,15 @@
 #include "Engine.hpp"
 #include "Fen.hpp"
 #include "Board.hpp"
+#include "CheessEngine.hpp"
+#include "TranspositionTable.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 static std::unique_ptr<Engine> createEngine() {
     return EngineFactory::createEngine();
@@ -46,3 +55,243 @@ TEST_CASE("Engine detects stalemate", "[Engine][Stalemate]") {
 
     testGameEnd(fen, false);
 }
+
+TEST_CASE("Engine finds mate with helper threads", "[Engine][Threads]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+
+    auto threadsInfo = engine->threadsInfo();
+    REQUIRE(threadsInfo.has_value());
+    REQUIRE(threadsInfo->maxCount >= 4);
+    engine->setThreads(4);
+
+    // https://lichess.org/editor/6k1/5ppp/8/8/8/8/5PPP/3R2K1_w_-_-_0_1
+    auto board = Fen::createBoard("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1");
+    REQUIRE(board.has_value());
+
+    auto pv = engine->pv(board.value());
+
+    REQUIRE(pv.isMate());
+    REQUIRE(pv.score() == 1);
+    REQUIRE(pv.length() >= 1);
+    REQUIRE(*pv.begin() == Move(Square::D1, Square::D8));
+}
+
+TEST_CASE("Engine finds mate that needs zugzwang", "[Engine][NullMove]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+
+    // Black's lone bishop has no waiting move after 1.Ra6, so passing must not refute it
+    // https://lichess.org/editor/kbK5/pp6/1P6/8/8/8/8/R7_w_-_-_0_1
+    auto board = Fen::createBoard("kbK5/pp6/1P6/8/8/8/8/R7 w - - 0 1");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo = {};
+    timeInfo.depth = 8;
+    auto pv = engine->pv(board.value(), timeInfo);
+
+    REQUIRE(pv.isMate());
+    REQUIRE(pv.score() == 3);
+    REQUIRE(pv.length() >= 1);
+    REQUIRE(*pv.begin() == Move(Square::A1, Square::A6));
+}
+
+TEST_CASE("Engine respects the time it is given", "[Engine][Time]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo;
+    timeInfo.white = PlayerTimeInfo{std::chrono::milliseconds(200), std::chrono::milliseconds(0)};
+    timeInfo.black = timeInfo.white;
+
+    auto start = std::chrono::steady_clock::now();
+    auto pv = engine->pv(board.value(), timeInfo);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // Without its limits the engine would keep deepening for far longer, the exact limits are tested with TimeManager
+    REQUIRE(pv.length() > 0);
+    REQUIRE(elapsed < std::chrono::seconds(5));
+}
+
+TEST_CASE("Engine stops an infinite search on request", "[Engine][Time]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo = {};
+    timeInfo.infinite = true;
+
+    auto length = std::size_t(0);
+    auto search = std::thread([&] { length = engine->pv(board.value(), timeInfo).length(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    engine->stop();
+    search.join();
+
+    REQUIRE(length > 0);
+}
+
+TEST_CASE("Engine keeps a stop that arrives before the search starts", "[Engine][Time]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo = {};
+    timeInfo.infinite = true;
+
+    engine->stop();
+    REQUIRE(engine->pv(board.value(), timeInfo).length() > 0);
+}
+
+TEST_CASE("Engine draws by repeating positions of the game", "[Engine][Repetition]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+
+    // Black is lost, but the king shuffle already happened twice
+    auto board = Fen::createBoard("7k/8/8/8/8/2KQ4/8/R7 b - - 10 60");
+    REQUIRE(board.has_value());
+
+    auto history = std::vector<Zobrist::Key>();
+    for(auto i = 0; i < 2; i++) {
+        for(auto uci : {"h8g8", "a1a2", "g8h8", "a2a1"}) {
+            history.push_back(board->hash());
+            board->makeMove(Move::fromUci(uci).value());
+        }
+    }
+
+    auto lost = engine->pv(board.value());
+    REQUIRE(lost.score() < 0);
+
+    engine->setGameHistory(history);
+    auto pv = engine->pv(board.value());
+
+    REQUIRE(pv.score() == 0);
+    REQUIRE(pv.length() > 0);
+    REQUIRE(*pv.begin() == Move::fromUci("h8g8").value());
+}
+
+TEST_CASE("Engines leave a shared transposition table intact", "[Engine][TranspositionTable]") {
+    auto table = std::make_shared<TranspositionTable>(64 * 1024);
+    auto engine = CheessEngine(table);
+    auto other = CheessEngine(table);
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    auto timeInfo = TimeInfo();
+    timeInfo.depth = 4;
+    other.pv(board.value(), timeInfo);
+    REQUIRE(table->probe(board->hash()).has_value());
+
+    // Neither may free or wipe the buckets the other engine searches on
+    engine.newGame();
+    engine.setHashSize(2);
+    REQUIRE(table->size() <= 64 * 1024);
+    REQUIRE(table->probe(board->hash()).has_value());
+
+    // The engine keeps working on the table of its own
+    REQUIRE(engine.pv(board.value(), timeInfo).length() > 0);
+    REQUIRE(other.pv(board.value(), timeInfo).length() > 0);
+}
+
+TEST_CASE("Engine reports the nodes of its quiescence search", "[Engine][Quiescence]") {
+    auto engine = createEngine();
+    REQUIRE(engine != nullptr);
+    auto threads = GENERATE(1, 4);
+    engine->setThreads(threads);
+
+    // Tense position with captures available for both sides
+    auto board = Fen::createBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo = {};
+    timeInfo.depth = 4;
+    engine->pv(board.value(), timeInfo);
+
+    auto searchInfo = engine->searchInfo();
+    REQUIRE(searchInfo.has_value());
+    CAPTURE(threads);
+    REQUIRE(searchInfo->quiescenceNodes > 0);
+    REQUIRE(searchInfo->quiescenceNodes < searchInfo->nodes);
+}
+
+static std::uint64_t searchNodes(const CheessEngine::PruningMargins& margins) {
+    auto engine = CheessEngine();
+    engine.setPruningMargins(margins);
+
+    auto board = Fen::createBoard("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    REQUIRE(board.has_value());
+
+    TimeInfo timeInfo = {};
+    timeInfo.depth = 6;
+    engine.pv(board.value(), timeInfo);
+
+    auto searchInfo = engine.searchInfo();
+    REQUIRE(searchInfo.has_value());
+    REQUIRE(searchInfo->depth == 6);
+    return searchInfo->nodes;
+}
+
+TEST_CASE("Engine frontier pruning techniques each save nodes", "[Engine][Pruning]") {
+    auto margins = CheessEngine::PruningMargins();
+    auto nodes = searchNodes(margins);
+
+    auto withoutReverseFutility = margins;
+    withoutReverseFutility.reverse_futility_depth = 0;
+    REQUIRE(nodes < searchNodes(withoutReverseFutility));
+
+    auto withoutFutility = margins;
+    withoutFutility.futility_depth = 0;
+    REQUIRE(nodes < searchNodes(withoutFutility));
+
+    auto withoutRazoring = margins;
+    withoutRazoring.razoring_depth = 0;
+    REQUIRE(nodes < searchNodes(withoutRazoring));
+}
+
+TEST_CASE("Engine frontier pruning does not change puzzle solutions", "[Engine][Pruning]") {
+    // Small tables, the puzzles are shallow
+    auto pruning = CheessEngine(std::make_shared<TranspositionTable>(1024 * 1024));
+    auto noPruning = CheessEngine(std::make_shared<TranspositionTable>(1024 * 1024));
+    noPruning.setPruningMargins({0, 0, 0, 0, 0, 0});
+
+    auto puzzles = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(PUZZLES_DIR)) {
+        auto file = std::ifstream(entry.path());
+        for (std::string line; std::getline(file, line);) {
+            // id,fen,moves,... where the first move leads to the puzzle and the second solves it
+            auto fields = std::istringstream(line);
+            auto id = std::string(), fen = std::string(), moves = std::string();
+            std::getline(fields, id, ',');
+            std::getline(fields, fen, ',');
+            std::getline(fields, moves, ',');
+
+            auto board = Fen::createBoard(fen);
+            REQUIRE(board.has_value());
+            auto moveStream = std::istringstream(moves);
+            auto setup = std::string(), solution = std::string();
+            moveStream >> setup >> solution;
+            board->makeMove(Move::fromUci(setup).value());
+
+            CAPTURE(id);
+            pruning.newGame();
+            noPruning.newGame();
+            auto pruned = pruning.pv(board.value(), std::nullopt);
+            auto unpruned = noPruning.pv(board.value(), std::nullopt);
+
+            REQUIRE(pruned.length() > 0);
+            REQUIRE(unpruned.length() > 0);
+            REQUIRE(*pruned.begin() == Move::fromUci(solution).value());
+            REQUIRE(*unpruned.begin() == Move::fromUci(solution).value());
+            puzzles++;
+        }
+    }
+
+    REQUIRE(puzzles > 0);
+}
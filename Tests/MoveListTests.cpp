@@ -0,0 +1,77 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "MoveList.hpp"
+
+#include <vector>
+
+TEST_CASE("Move lists store moves in insertion order", "[MoveList][Fundamental]") {
+    auto moves = MoveList();
+    REQUIRE(moves.empty());
+
+    moves.push_back(Move(Square::E2, Square::E4));
+    moves.push_back(Move(Square::G1, Square::F3));
+    moves.push_back(Move(Square::A7, Square::A8, PieceType::Queen));
+
+    REQUIRE(moves.size() == 3);
+    REQUIRE(moves[1] == Move(Square::G1, Square::F3));
+
+    auto iterated = std::vector<Move>(moves.begin(), moves.end());
+    REQUIRE(iterated == std::vector<Move>{
+        Move(Square::E2, Square::E4),
+        Move(Square::G1, Square::F3),
+        Move(Square::A7, Square::A8, PieceType::Queen)
+    });
+
+    moves.clear();
+    REQUIRE(moves.empty());
+}
+
+TEST_CASE("Move lists hold a full capacity of moves", "[MoveList]") {
+    auto moves = MoveList();
+    for (std::size_t i = 0; i < MoveList::capacity; i++) {
+        moves.push_back(Move(Square::E2, Square::E4));
+    }
+    REQUIRE(moves.size() == MoveList::capacity);
+}
+
+TEST_CASE("Move lists keep scores with their moves", "[MoveList]") {
+    auto moves = MoveList();
+    moves.push_back(Move(Square::E2, Square::E4));
+    moves.push_back(Move(Square::D2, Square::D4));
+    moves.score(0) = 10;
+    moves.score(1) = 20;
+
+    moves.swap(0, 1);
+
+    REQUIRE(moves[0] == Move(Square::D2, Square::D4));
+    REQUIRE(moves.score(0) == 20);
+    REQUIRE(moves[1] == Move(Square::E2, Square::E4));
+    REQUIRE(moves.score(1) == 10);
+}
+
+TEST_CASE("Move lists select moves in order of their scores", "[MoveList]") {
+    auto moves = MoveList();
+    moves.push_back(Move(Square::E2, Square::E4));
+    moves.push_back(Move(Square::D2, Square::D4));
+    moves.push_back(Move(Square::C2, Square::C4));
+    moves.push_back(Move(Square::B2, Square::B4));
+    moves.score(0) = 5;
+    moves.score(1) = -3;
+    moves.score(2) = 40;
+    moves.score(3) = 7;
+
+    auto selected = std::vector<Move>();
+    for (std::size_t i = 0; i < moves.size(); i++) {
+        moves.selectBest(i);
+        selected.push_back(moves[i]);
+    }
+
+    REQUIRE(selected == std::vector<Move>{
+        Move(Square::C2, Square::C4),
+        Move(Square::B2, Square::B4),
+        Move(Square::E2, Square::E4),
+        Move(Square::D2, Square::D4)
+    });
+}
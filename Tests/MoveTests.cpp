@@ -109,3 +109,23 @@ TEST_CASE("Moves are not created from invalid UCI notation", "[Move][Fundamental
     CAPTURE(uci, move);
     REQUIRE_FALSE(move.has_value());
 }
+
+TEST_CASE("Moves are packed into 16 bits", "[Move][Fundamental]") {
+    auto promotion = GENERATE(as<std::optional<PieceType>>(),
+        std::nullopt, PieceType::Knight, PieceType::Bishop, PieceType::Rook, PieceType::Queen);
+
+    auto move = Move(Square::H7, Square::G8, promotion);
+
+    CAPTURE(move);
+    REQUIRE(sizeof(move) == 2);
+    REQUIRE(move.fromIndex() == Square::H7.index());
+    REQUIRE(move.toIndex() == Square::G8.index());
+    REQUIRE(move.isPromotion() == promotion.has_value());
+    REQUIRE((move.promotion() == promotion));
+
+    move.setFrom(Square::A2);
+    move.setTo(Square::B1);
+    REQUIRE(move.from() == Square::A2);
+    REQUIRE(move.to() == Square::B1);
+    REQUIRE((move.promotion() == promotion));
+}
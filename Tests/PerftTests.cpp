@@ -0,0 +1,99 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "Perft.hpp"
+#include "Fen.hpp"
+#include "Board.hpp"
+
+#include <sstream>
+
+// Node counts from https://www.chessprogramming.org/Perft_Results
+static void testPerft(const char* fen, unsigned depth, Perft::NodeCount expectedNodes) {
+    auto board = Fen::createBoard(fen);
+    REQUIRE(board.has_value());
+
+    auto nodes = Perft::perft(board.value(), depth);
+
+    CAPTURE(fen, depth);
+    REQUIRE(nodes == expectedNodes);
+}
+
+#define TEST_CASE_PERFT(name, tag) \
+    TEST_CASE(name, "[Perft]" tag)
+
+TEST_CASE_PERFT("Perft, initial position", "") {
+    auto [depth, nodes] = GENERATE(table<unsigned, Perft::NodeCount>({
+        {0, 1}, {1, 20}, {2, 400}, {3, 8902}, {4, 197281}
+    }));
+
+    testPerft(Fen::StartingPos, depth, nodes);
+}
+
+TEST_CASE_PERFT("Perft, Kiwipete", "[Castling][EnPassant][Promotion]") {
+    // https://lichess.org/editor/r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R_w_KQkq_-_0_1
+    auto [depth, nodes] = GENERATE(table<unsigned, Perft::NodeCount>({
+        {1, 48}, {2, 2039}, {3, 97862}
+    }));
+
+    testPerft("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", depth, nodes);
+}
+
+TEST_CASE_PERFT("Perft, position 3", "[EnPassant][Pin]") {
+    // https://lichess.org/editor/8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8_w_-_-_0_1
+    auto [depth, nodes] = GENERATE(table<unsigned, Perft::NodeCount>({
+        {1, 14}, {2, 191}, {3, 2812}, {4, 43238}, {5, 674624}
+    }));
+
+    testPerft("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", depth, nodes);
+}
+
+TEST_CASE_PERFT("Perft, position 4", "[Castling][Promotion][Check]") {
+    // https://lichess.org/editor/r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1_w_kq_-_0_1
+    auto fen = GENERATE(
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        // Mirrored, must give the same counts
+        "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1"
+    );
+    auto [depth, nodes] = GENERATE(table<unsigned, Perft::NodeCount>({
+        {1, 6}, {2, 264}, {3, 9467}, {4, 422333}
+    }));
+
+    testPerft(fen, depth, nodes);
+}
+
+TEST_CASE_PERFT("Perft, position 5", "[Castling][Promotion]") {
+    // https://lichess.org/editor/rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R_w_KQ_-_1_8
+    auto [depth, nodes] = GENERATE(table<unsigned, Perft::NodeCount>({
+        {1, 44}, {2, 1486}, {3, 62379}
+    }));
+
+    testPerft("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", depth, nodes);
+}
+
+TEST_CASE_PERFT("Perft, position 6", "") {
+    // https://lichess.org/editor/r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1_w_-_-_0_10
+    auto [depth, nodes] = GENERATE(table<unsigned, Perft::NodeCount>({
+        {1, 46}, {2, 2079}, {3, 89890}
+    }));
+
+    testPerft("r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", depth, nodes);
+}
+
+TEST_CASE_PERFT("Perft divide adds up to the perft count", "") {
+    auto board = Fen::createBoard("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    REQUIRE(board.has_value());
+
+    auto divide = Perft::divide(board.value(), 2);
+    REQUIRE(divide.size() == 48);
+
+    auto total = Perft::NodeCount(0);
+    for (const auto& [move, nodes] : divide) {
+        total += nodes;
+    }
+    REQUIRE(total == 2039);
+
+    auto report = std::stringstream();
+    REQUIRE(Perft::report(board.value(), 2, report) == 2039);
+    REQUIRE(report.str().find("Nodes searched: 2039") != std::string::npos);
+}
@@ -78,3 +78,16 @@ TEST_CASE("Squares stream their name correctly", "[Square][Fundamental]") {
     stream << square;
     REQUIRE(stream.str() == name);
 }
+
+TEST_CASE("Squares are usable in constant expressions", "[Square][Fundamental]") {
+    static_assert(sizeof(Square) == 1);
+    static_assert(Square::G3.index() == 22);
+    static_assert(Square::G3.file() == 6 && Square::G3.rank() == 2);
+    static_assert(Square::fromIndexUnchecked(22) == Square::G3);
+    static_assert(Square::fromCoordinatesUnchecked(6, 2) == Square::G3);
+    static_assert(!Square::fromIndex(64).has_value());
+
+    constexpr auto square = Square::fromCoordinates(3, 7);
+    REQUIRE(square.has_value());
+    REQUIRE(square.value() == Square::D8);
+}
@@ -0,0 +1,107 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "TimeManager.hpp"
+
+using namespace std::chrono_literals;
+
+static TimeInfo timeInfo(std::chrono::milliseconds white, std::chrono::milliseconds black,
+                         std::chrono::milliseconds increment = 0ms,
+                         std::optional<unsigned> movesToGo = std::nullopt) {
+    TimeInfo info;
+    info.white = PlayerTimeInfo{white, increment};
+    info.black = PlayerTimeInfo{black, increment};
+    info.movesToGo = movesToGo;
+    return info;
+}
+
+TEST_CASE("Time managers without time info have no limits", "[TimeManager]") {
+    auto manager = TimeManager();
+
+    REQUIRE_FALSE(manager.hasLimits());
+    REQUIRE_FALSE(manager.softLimitReached());
+    REQUIRE_FALSE(manager.hardLimitReached());
+}
+
+TEST_CASE("Time managers use the clock of the side to move", "[TimeManager]") {
+    auto info = timeInfo(60000ms, 3000ms);
+
+    auto white = TimeManager(info, PieceColor::White);
+    auto black = TimeManager(info, PieceColor::Black);
+
+    REQUIRE(white.hasLimits());
+    REQUIRE(black.hasLimits());
+    REQUIRE(white.softLimit().value() > black.softLimit().value());
+    REQUIRE(white.hardLimit().value() > black.hardLimit().value());
+}
+
+TEST_CASE("Time manager limits stay within the remaining time", "[TimeManager]") {
+    auto [timeLeft, increment, movesToGo] = GENERATE(table<unsigned, unsigned, std::optional<unsigned>>({
+        {60000, 0, std::nullopt},
+        {60000, 1000, std::nullopt},
+        {1000, 5000, std::nullopt},
+        {60000, 0, 1},
+        {10, 0, std::nullopt},
+        {0, 0, 5}
+    }));
+
+    auto info = timeInfo(std::chrono::milliseconds(timeLeft), 1000ms,
+                         std::chrono::milliseconds(increment), movesToGo);
+    auto manager = TimeManager(info, PieceColor::White);
+
+    CAPTURE(timeLeft, increment);
+    REQUIRE(manager.softLimit().value() <= manager.hardLimit().value());
+    REQUIRE(manager.hardLimit().value() > 0ms);
+    REQUIRE(manager.hardLimit().value() <= std::max(std::chrono::milliseconds(timeLeft) * 3 / 4, 1ms));
+}
+
+TEST_CASE("Time managers spend more time with fewer moves to go", "[TimeManager]") {
+    auto many = TimeManager(timeInfo(60000ms, 60000ms, 0ms, 40), PieceColor::White);
+    auto few = TimeManager(timeInfo(60000ms, 60000ms, 0ms, 4), PieceColor::White);
+
+    REQUIRE(few.softLimit().value() > many.softLimit().value());
+}
+
+TEST_CASE("Time managers for infinite searches have no limits", "[TimeManager]") {
+    auto info = timeInfo(10ms, 10ms);
+    info.infinite = true;
+    auto manager = TimeManager(info, PieceColor::White);
+
+    REQUIRE(manager.isInfinite());
+    REQUIRE_FALSE(manager.hasLimits());
+    REQUIRE_FALSE(manager.hardLimitReached());
+}
+
+TEST_CASE("Time managers for fixed depth searches have no limits", "[TimeManager]") {
+    auto info = timeInfo(10ms, 10ms);
+    info.depth = 4;
+    auto manager = TimeManager(info, PieceColor::White);
+
+    REQUIRE_FALSE(manager.isInfinite());
+    REQUIRE_FALSE(manager.hasLimits());
+}
+
+TEST_CASE("Time managers reach their limits at the given elapsed times", "[TimeManager]") {
+    auto manager = TimeManager(timeInfo(200ms, 200ms), PieceColor::White);
+    auto soft = manager.softLimit().value();
+    auto hard = manager.hardLimit().value();
+
+    REQUIRE(soft < hard);
+
+    REQUIRE_FALSE(manager.softLimitReached(0ms));
+    REQUIRE_FALSE(manager.softLimitReached(soft - 1ms));
+    REQUIRE(manager.softLimitReached(soft));
+    REQUIRE_FALSE(manager.hardLimitReached(soft));
+
+    REQUIRE_FALSE(manager.hardLimitReached(hard - 1ms));
+    REQUIRE(manager.hardLimitReached(hard));
+    REQUIRE(manager.hardLimitReached(200ms));
+}
+
+TEST_CASE("Time managers without limits are never reached", "[TimeManager]") {
+    auto manager = TimeManager();
+
+    REQUIRE_FALSE(manager.softLimitReached(std::chrono::hours(24)));
+    REQUIRE_FALSE(manager.hardLimitReached(std::chrono::hours(24)));
+}
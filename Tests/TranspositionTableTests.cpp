@@ -0,0 +1,142 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "TranspositionTable.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using Bound = TranspositionTable::Bound;
+
+TEST_CASE("Transposition tables return stored entries", "[TranspositionTable][Fundamental]") {
+    auto table = TranspositionTable(1024 * 1024);
+    auto key = Zobrist::Key(0x123456789ABCDEF0);
+    auto move = Move(Square::E7, Square::E8, PieceType::Queen);
+
+    REQUIRE_FALSE(table.probe(key).has_value());
+
+    table.store(key, move, -99990, 12, Bound::Lower);
+
+    auto entry = table.probe(key);
+    REQUIRE(entry.has_value());
+    REQUIRE(entry->move == move);
+    REQUIRE(entry->score == -99990);
+    REQUIRE(entry->depth == 12);
+    REQUIRE(entry->bound == Bound::Lower);
+
+    REQUIRE_FALSE(table.probe(key ^ 1).has_value());
+
+    table.clear();
+    REQUIRE_FALSE(table.probe(key).has_value());
+}
+
+TEST_CASE("Transposition tables use exactly the requested memory", "[TranspositionTable]") {
+    auto bytes = GENERATE(64, 640, 1024 * 1024, 3 * 1000 * 1000);
+    auto table = TranspositionTable(bytes);
+
+    CAPTURE(bytes);
+    REQUIRE(table.size() <= static_cast<std::size_t>(bytes));
+    REQUIRE(table.size() > static_cast<std::size_t>(bytes) - 64);
+
+    table.resize(2 * bytes);
+    REQUIRE(table.size() <= 2 * static_cast<std::size_t>(bytes));
+}
+
+TEST_CASE("Transposition tables keep the move when storing without one", "[TranspositionTable]") {
+    auto table = TranspositionTable(1024);
+    auto key = Zobrist::Key(42);
+    auto move = Move(Square::G1, Square::F3);
+
+    table.store(key, move, 10, 3, Bound::Exact);
+    table.store(key, Move(), 20, 4, Bound::Upper);
+
+    auto entry = table.probe(key);
+    REQUIRE(entry.has_value());
+    REQUIRE(entry->move == move);
+    REQUIRE(entry->score == 20);
+    REQUIRE(entry->bound == Bound::Upper);
+}
+
+TEST_CASE("Transposition tables replace shallow and old entries first", "[TranspositionTable]") {
+    // A single bucket, every key lands in it
+    auto table = TranspositionTable(64);
+    auto move = Move(Square::A2, Square::A4);
+
+    table.store(1, move, 0, 10, Bound::Exact);
+    table.store(2, move, 0, 2, Bound::Exact);
+    table.store(3, move, 0, 8, Bound::Exact);
+    table.store(4, move, 0, 9, Bound::Exact);
+    table.store(5, move, 0, 5, Bound::Exact);
+
+    REQUIRE_FALSE(table.probe(2).has_value());
+    REQUIRE(table.probe(1).has_value());
+    REQUIRE(table.probe(5).has_value());
+
+    // Deep entries of an earlier search make way for the current one
+    table.newSearch();
+    table.newSearch();
+    table.store(6, move, 0, 1, Bound::Exact);
+
+    REQUIRE(table.probe(6).has_value());
+    REQUIRE_FALSE(table.probe(5).has_value());
+}
+
+// Every writer stores its own move and score for a key, a probe must never mix the words of two writes
+static Move stressMove(unsigned keyIndex, unsigned writer) {
+    return Move(Square::fromIndexUnchecked(keyIndex % 64),
+                Square::fromIndexUnchecked((keyIndex + writer + 1) % 64));
+}
+
+static TranspositionTable::Score stressScore(unsigned keyIndex, unsigned writer) {
+    return static_cast<TranspositionTable::Score>(keyIndex * 1000 + writer);
+}
+
+TEST_CASE("Transposition tables never return torn entries under concurrent access", "[TranspositionTable][Threads]") {
+    // Four buckets for many more keys, so the threads keep overwriting each other's slots
+    auto table = TranspositionTable(4 * 64);
+    constexpr unsigned threadCount = 8;
+    constexpr unsigned iterations = 200000;
+    constexpr unsigned keyCount = 64;
+
+    auto corruptEntries = std::atomic<unsigned>(0);
+    auto hits = std::atomic<unsigned>(0);
+
+    auto worker = [&](unsigned writer) {
+        auto random = std::uint64_t(writer + 1) * 0x9E3779B97F4A7C15ULL;
+
+        for (unsigned i = 0; i < iterations; i++) {
+            random ^= random << 13;
+            random ^= random >> 7;
+            random ^= random << 17;
+
+            auto keyIndex = static_cast<unsigned>(random % keyCount);
+            auto key = Zobrist::Key(keyIndex + 1) * 0xD6E8FEB86659FD93ULL;
+
+            if ((random >> 32) & 1) {
+                // The depth identifies the writer, so a probe can check the rest of the entry against it
+                table.store(key, stressMove(keyIndex, writer), stressScore(keyIndex, writer), writer, Bound::Exact);
+            } else if (auto entry = table.probe(key); entry.has_value()) {
+                hits++;
+                if (entry->depth >= threadCount ||
+                    !(entry->move == stressMove(keyIndex, entry->depth)) ||
+                    entry->score != stressScore(keyIndex, entry->depth) ||
+                    entry->bound != Bound::Exact) {
+                    corruptEntries++;
+                }
+            }
+        }
+    };
+
+    auto threads = std::vector<std::thread>();
+    for (unsigned writer = 0; writer < threadCount; writer++) {
+        threads.emplace_back(worker, writer);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(hits > 0);
+    REQUIRE(corruptEntries == 0);
+}
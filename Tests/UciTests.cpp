@@ -0,0 +1,82 @@
+#include "catch2/catch.hpp"
+
+#include "TestUtils.hpp"
+
+#include "Uci.hpp"
+#include "EngineFactory.hpp"
+#include "Engine.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+//Runs the commands through a Uci instance and returns every line it sent
+static std::vector<std::string> runUci(const std::string& commands) {
+    auto input = std::istringstream(commands);
+    auto output = std::ostringstream();
+    auto log = std::ostringstream();
+
+    auto uci = Uci(EngineFactory::createEngine(), input, output, log);
+    uci.run();
+
+    auto lines = std::vector<std::string>();
+    auto sent = std::istringstream(output.str());
+    for (std::string line; std::getline(sent, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static std::size_t findLine(const std::vector<std::string>& lines, const std::string& prefix) {
+    for (std::size_t i = 0; i < lines.size(); i++) {
+        if (lines[i].rfind(prefix, 0) == 0) return i;
+    }
+    return lines.size();
+}
+
+TEST_CASE("UCI infinite searches answer isready and end on stop", "[Uci]") {
+    auto lines = runUci("position startpos\ngo infinite\nisready\nstop\n");
+
+    auto readyok = findLine(lines, "readyok");
+    auto bestmove = findLine(lines, "bestmove");
+
+    REQUIRE(readyok < lines.size());
+    REQUIRE(bestmove < lines.size());
+    REQUIRE(readyok < bestmove);
+}
+
+TEST_CASE("UCI searches still send their best move at the end of input", "[Uci]") {
+    auto lines = runUci("position startpos moves e2e4\ngo wtime 100 btime 100\n");
+
+    REQUIRE(findLine(lines, "bestmove") < lines.size());
+}
+
+TEST_CASE("UCI stop without a running search is ignored", "[Uci]") {
+    auto lines = runUci("stop\nisready\n");
+
+    REQUIRE(lines == std::vector<std::string>{"readyok"});
+}
+
+TEST_CASE("UCI depth limited searches send their best move", "[Uci]") {
+    auto lines = runUci("position startpos\ngo depth 3\n");
+
+    REQUIRE(findLine(lines, "info depth 3 nodes ") < lines.size());
+    REQUIRE(findLine(lines, "bestmove") < lines.size());
+}
+
+TEST_CASE("UCI position moves feed the game history used for repetitions", "[Uci][Repetition]") {
+    // Black is lost, but after the king shuffle below h8g8 repeats a position for the third time
+    auto position = std::string("position fen 7k/8/8/8/8/2KQ4/8/R7 b - - 10 60");
+    auto shuffle = std::string(" moves h8g8 a1a2 g8h8 a2a1 h8g8 a1a2 g8h8 a2a1");
+
+    auto lost = runUci(position + "\ngo depth 4\n");
+    auto info = findLine(lost, "info ");
+    REQUIRE(info < lost.size());
+    REQUIRE(lost[info].find("score cp 0 ") == std::string::npos);
+
+    auto drawn = runUci(position + shuffle + "\ngo depth 4\n");
+    info = findLine(drawn, "info ");
+    REQUIRE(info < drawn.size());
+    REQUIRE(drawn[info].find("score cp 0 ") != std::string::npos);
+    REQUIRE(findLine(drawn, "bestmove h8g8") < drawn.size());
+}
@@ -15,6 +15,12 @@ struct TimeInfo {
     PlayerTimeInfo white;
     PlayerTimeInfo black;
     std::optional<unsigned> movesToGo;
+
+    //Search until stopped, the clocks are ignored
+    bool infinite = false;
+
+    //Search this many plies deep, the clocks are ignored
+    std::optional<unsigned> depth;
 };
 
 #endif
@@ -0,0 +1,61 @@
+#include "TimeManager.hpp"
+
+#include <algorithm>
+
+TimeManager::TimeManager(const TimeInfo::Optional& time_info, PieceColor turn) : start{Clock::now()} {
+    if(!time_info.has_value()) return;
+    if(time_info->infinite) {
+        infinite = true;
+        return;
+    }
+    if(time_info->depth.has_value()) return;
+
+    const PlayerTimeInfo& player = turn == PieceColor::White ? time_info->white : time_info->black;
+    Duration available = std::max(player.timeLeft - move_overhead, Duration(1));
+    unsigned moves_to_go = std::max(time_info->movesToGo.value_or(default_moves_to_go), 1u);
+
+    //An even share of the remaining time plus most of the increment, never more than the hard limit
+    //The hard limit allows running over for hard positions while always leaving time for the next moves
+    Duration soft = available / moves_to_go + player.increment * 3 / 4;
+    Duration hard = std::min(soft * 4, available * 3 / 4);
+    hard = std::max(hard, Duration(1));
+
+    soft_limit = std::min(soft, hard);
+    hard_limit = hard;
+}
+
+bool TimeManager::hasLimits() const {
+    return hard_limit.has_value();
+}
+
+bool TimeManager::isInfinite() const {
+    return infinite;
+}
+
+std::optional<TimeManager::Duration> TimeManager::softLimit() const {
+    return soft_limit;
+}
+
+std::optional<TimeManager::Duration> TimeManager::hardLimit() const {
+    return hard_limit;
+}
+
+TimeManager::Duration TimeManager::elapsed() const {
+    return std::chrono::duration_cast<Duration>(Clock::now() - start);
+}
+
+bool TimeManager::softLimitReached() const {
+    return softLimitReached(elapsed());
+}
+
+bool TimeManager::hardLimitReached() const {
+    return hardLimitReached(elapsed());
+}
+
+bool TimeManager::softLimitReached(Duration elapsed_time) const {
+    return soft_limit.has_value() && elapsed_time >= soft_limit.value();
+}
+
+bool TimeManager::hardLimitReached(Duration elapsed_time) const {
+    return hard_limit.has_value() && elapsed_time >= hard_limit.value();
+}
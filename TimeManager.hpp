@@ -0,0 +1,50 @@
+#ifndef CHESS_ENGINE_TIMEMANAGER_HPP
+#define CHESS_ENGINE_TIMEMANAGER_HPP
+
+#include "TimeInfo.hpp"
+#include "Piece.hpp"
+
+#include <chrono>
+#include <optional>
+
+//Decides how long a search may take for the side to move
+//The soft limit ends iterative deepening between iterations, the hard limit aborts a running iteration
+class TimeManager {
+public:
+
+    using Clock = std::chrono::steady_clock;
+    using Duration = std::chrono::milliseconds;
+
+    //Starts the clock, without time info or with a fixed depth there are no limits
+    TimeManager(const TimeInfo::Optional& time_info = std::nullopt, PieceColor turn = PieceColor::White);
+
+    bool hasLimits() const;
+
+    //No limits and no fixed depth either, only stopping ends the search
+    bool isInfinite() const;
+    std::optional<Duration> softLimit() const;
+    std::optional<Duration> hardLimit() const;
+
+    Duration elapsed() const;
+    bool softLimitReached() const;
+    bool hardLimitReached() const;
+
+    //The same checks for a given elapsed time instead of the clock, so they can be tested deterministically
+    bool softLimitReached(Duration elapsed_time) const;
+    bool hardLimitReached(Duration elapsed_time) const;
+
+    //Time kept in reserve for communication with the GUI
+    static constexpr Duration move_overhead{30};
+
+    //Moves assumed to be left until the next time control when the GUI does not say
+    static constexpr unsigned default_moves_to_go = 30;
+
+private:
+
+    Clock::time_point start;
+    bool infinite = false;
+    std::optional<Duration> soft_limit;
+    std::optional<Duration> hard_limit;
+};
+
+#endif
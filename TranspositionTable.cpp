@@ -0,0 +1,123 @@
+#include "TranspositionTable.hpp"
+
+#include <algorithm>
+
+constexpr unsigned generation_bits = 6;
+constexpr std::uint8_t generation_mask = (1u << generation_bits) - 1;
+
+TranspositionTable::TranspositionTable(std::size_t bytes) {
+    resize(bytes);
+}
+
+void TranspositionTable::resize(std::size_t bytes) {
+    //Keep at least one bucket so lookups never have to check for an empty table
+    bucket_count = std::max<std::size_t>(bytes / sizeof(Bucket), 1);
+    buckets = std::make_unique<Bucket[]>(bucket_count);
+    generation = 0;
+}
+
+void TranspositionTable::clear() {
+    for(std::size_t i = 0; i < bucket_count; i++) {
+        for(Slot& slot : buckets[i].slots) slot.save(0, 0);
+    }
+    generation = 0;
+}
+
+void TranspositionTable::newSearch() {
+    generation.store((generation.load(std::memory_order_relaxed) + 1) & generation_mask, std::memory_order_relaxed);
+}
+
+std::size_t TranspositionTable::size() const {
+    return bucket_count * sizeof(Bucket);
+}
+
+//The high half of key * bucket count maps keys uniformly onto any number of buckets without a division
+static std::size_t bucketIndex(Zobrist::Key key, std::size_t bucket_count) {
+    std::uint64_t count = bucket_count;
+    std::uint64_t key_low = key & 0xFFFFFFFF, key_high = key >> 32;
+    std::uint64_t count_low = count & 0xFFFFFFFF, count_high = count >> 32;
+
+    std::uint64_t cross = (key_low * count_low >> 32) + (key_high * count_low & 0xFFFFFFFF) + key_low * count_high;
+    return key_high * count_high + (key_high * count_low >> 32) + (cross >> 32);
+}
+
+const TranspositionTable::Bucket& TranspositionTable::bucketFor(Zobrist::Key key) const {
+    return buckets[bucketIndex(key, bucket_count)];
+}
+
+TranspositionTable::Bucket& TranspositionTable::bucketFor(Zobrist::Key key) {
+    return buckets[bucketIndex(key, bucket_count)];
+}
+
+//Relaxed ordering is enough: the key check catches every mix of two writes, the search tolerates stale entries
+void TranspositionTable::Slot::save(Zobrist::Key key, std::uint64_t new_data) {
+    data.store(new_data, std::memory_order_relaxed);
+    key_xor_data.store(key ^ new_data, std::memory_order_relaxed);
+}
+
+std::optional<TranspositionTable::Entry> TranspositionTable::probe(Zobrist::Key key) const {
+    for(const Slot& slot : bucketFor(key).slots) {
+        //Read each word once, the entry is only used when both words belong to the same write
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        Zobrist::Key key_xor_data = slot.key_xor_data.load(std::memory_order_relaxed);
+        if(data != 0 && (key_xor_data ^ data) == key) return unpack(data);
+    }
+    return std::nullopt;
+}
+
+void TranspositionTable::store(Zobrist::Key key, Move move, Score score, unsigned depth, Bound bound) {
+    Bucket& bucket = bucketFor(key);
+    std::uint8_t current_generation = generation.load(std::memory_order_relaxed);
+
+    //Replace the entry of the same position, otherwise the least valuable one:
+    //shallow entries from older searches go first, an empty slot is never worth anything
+    Slot* replace = nullptr;
+    std::uint64_t replace_data = 0;
+    int replace_value = 0;
+    for(Slot& slot : bucket.slots) {
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        if(data == 0 || (slot.key_xor_data.load(std::memory_order_relaxed) ^ data) == key) {
+            replace = &slot;
+            replace_data = data;
+            break;
+        }
+        int age = (current_generation - generationOf(data)) & generation_mask;
+        int value = static_cast<int>(unpack(data).depth) - 8 * age;
+        if(replace == nullptr || value < replace_value) {
+            replace = &slot;
+            replace_data = data;
+            replace_value = value;
+        }
+    }
+
+    //replace_data may be torn by a concurrent write, it only steers the replacement decision
+    if(replace_data != 0 && (replace->key_xor_data.load(std::memory_order_relaxed) ^ replace_data) == key) {
+        Entry existing = unpack(replace_data);
+        if(move == Move()) move = existing.move;
+        //Keep a deeper result of the current search unless the new one is exact
+        if(bound != Bound::Exact && existing.depth > depth + 2 && generationOf(replace_data) == current_generation) return;
+    }
+
+    replace->save(key, pack(move, score, depth, bound, current_generation));
+}
+
+std::uint64_t TranspositionTable::pack(Move move, Score score, unsigned depth, Bound bound, std::uint8_t generation) {
+    return static_cast<std::uint64_t>(move.encoding())
+         | static_cast<std::uint64_t>(static_cast<std::uint32_t>(score)) << 16
+         | static_cast<std::uint64_t>(std::min(depth, 255u)) << 48
+         | static_cast<std::uint64_t>(bound) << 56
+         | static_cast<std::uint64_t>(generation) << 58;
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(std::uint64_t data) {
+    Entry entry;
+    entry.move = Move::fromEncoding(static_cast<Move::Encoding>(data & 0xFFFF));
+    entry.score = static_cast<Score>(static_cast<std::uint32_t>(data >> 16));
+    entry.depth = (data >> 48) & 0xFF;
+    entry.bound = static_cast<Bound>((data >> 56) & 0x3);
+    return entry;
+}
+
+std::uint8_t TranspositionTable::generationOf(std::uint64_t data) {
+    return data >> 58;
+}
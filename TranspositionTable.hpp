@@ -0,0 +1,86 @@
+#ifndef CHESS_ENGINE_TRANSPOSITIONTABLE_HPP
+#define CHESS_ENGINE_TRANSPOSITIONTABLE_HPP
+
+#include "Move.hpp"
+#include "Zobrist.hpp"
+#include "PrincipalVariation.hpp"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+//Fixed-size hash table of search results, made of cache line sized buckets of compact entries
+//probe and store can be called from any number of threads at once without locking, resize and clear cannot
+class TranspositionTable {
+public:
+
+    using Score = PrincipalVariation::Score;
+
+    //How the stored score relates to the real score of the position
+    enum class Bound : std::uint8_t {
+        None,
+        Exact,
+        Lower, //Failed high, the real score is at least the stored score
+        Upper  //Failed low, the real score is at most the stored score
+    };
+
+    struct Entry {
+        Move move;
+        Score score;
+        unsigned depth;
+        Bound bound;
+    };
+
+    //Uses as many buckets as fit in the given amount of bytes
+    explicit TranspositionTable(std::size_t bytes);
+
+    void resize(std::size_t bytes);
+    void clear();
+
+    //Called at the start of every search so entries of earlier searches are replaced first
+    void newSearch();
+
+    std::optional<Entry> probe(Zobrist::Key key) const;
+
+    //An empty move (a1a1) keeps the move already stored for the position
+    void store(Zobrist::Key key, Move move, Score score, unsigned depth, Bound bound);
+
+    //Allocated size in bytes
+    std::size_t size() const;
+
+private:
+
+    //One entry packed in two words, data holds move (16 bits), score (32), depth (8), bound (2) and generation (6)
+    //The key is stored XORed with the data: a slot read while another thread writes it no longer matches its key
+    struct Slot {
+        std::atomic<Zobrist::Key> key_xor_data{0};
+        std::atomic<std::uint64_t> data{0};
+
+        void save(Zobrist::Key key, std::uint64_t new_data);
+    };
+
+    static constexpr std::size_t cache_line_size = 64;
+    static constexpr std::size_t bucket_slots = cache_line_size / sizeof(Slot);
+
+    struct alignas(cache_line_size) Bucket {
+        std::array<Slot, bucket_slots> slots;
+    };
+
+    static_assert(sizeof(Bucket) == cache_line_size);
+
+    std::unique_ptr<Bucket[]> buckets;
+    std::size_t bucket_count = 0;
+    std::atomic<std::uint8_t> generation = 0;
+
+    const Bucket& bucketFor(Zobrist::Key key) const;
+    Bucket& bucketFor(Zobrist::Key key);
+
+    static std::uint64_t pack(Move move, Score score, unsigned depth, Bound bound, std::uint8_t generation);
+    static Entry unpack(std::uint64_t data);
+    static std::uint8_t generationOf(std::uint64_t data);
+};
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "Engine.hpp"
 #include "Fen.hpp"
+#include "Perft.hpp"
 
 #include <cstdint>
 #include <utility>
@@ -9,6 +10,7 @@
 #include <sstream>
 #include <cstdlib>
 #include <cmath>
+#include <chrono>
 
 class UciOptionBase {
 public:
@@ -121,6 +123,41 @@ private:
     HashInfo hashInfo_;
 };
 
+class UciThreadsOption : public UciSpinOption<std::size_t> {
+public:
+
+    UciThreadsOption(const ThreadsInfo& threadsInfo) : threadsInfo_(threadsInfo) {}
+
+    std::string name() const override {
+        return "Threads";
+    }
+
+    OptionalValue default_() const override {
+        return threadsInfo_.defaultCount;
+    }
+
+    OptionalValue min() const override {
+        return threadsInfo_.minCount;
+    }
+
+    OptionalValue max() const override {
+        return threadsInfo_.maxCount;
+    }
+
+    bool setValue(Engine& engine, Value value) const override {
+        if (value >= threadsInfo_.minCount && value <= threadsInfo_.maxCount) {
+            engine.setThreads(value);
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+private:
+
+    ThreadsInfo threadsInfo_;
+};
+
 Uci::Uci(std::unique_ptr<Engine> engine,
          std::istream& cmdIn,
          std::ostream& cmdOut,
@@ -130,11 +167,18 @@ Uci::Uci(std::unique_ptr<Engine> engine,
         auto hashOption = std::make_unique<UciHashOption>(*hashInfo);
         options_[hashOption->name()] = std::move(hashOption);
     }
+
+    if (auto threadsInfo = engine_->threadsInfo(); threadsInfo) {
+        auto threadsOption = std::make_unique<UciThreadsOption>(*threadsInfo);
+        options_[threadsOption->name()] = std::move(threadsOption);
+    }
 }
 
 // Needed here because Engine is only forward-declared in Uci.hpp causing an
 // error when compiling the destructor of std::unique_ptr.
-Uci::~Uci() = default;
+Uci::~Uci() {
+    stopSearch();
+}
 
 void Uci::run() {
     log_ << "UCI engine started" << std::endl;
@@ -144,10 +188,15 @@ void Uci::run() {
         std::getline(cmdIn_, line);
         runCommand(line);
     }
+
+    waitForSearch();
 }
 
 void Uci::runCommand(const std::string& line) {
-    log_ << "> " << line << std::endl;
+    {
+        auto lock = std::lock_guard(outputMutex_);
+        log_ << "> " << line << std::endl;
+    }
 
     auto stream = std::stringstream(line);
     auto command = std::string();
@@ -165,6 +214,8 @@ void Uci::runCommand(const std::string& line) {
         positionCommand(stream);
     } else if (command == "go") {
         goCommand(stream);
+    } else if (command == "stop") {
+        stopCommand(stream);
     } else if (command == "quit") {
         quitCommand(stream);
     }
@@ -188,10 +239,13 @@ void Uci::isreadyCommand(std::istream&) {
 }
 
 void Uci::ucinewgameCommand(std::istream&) {
+    stopSearch();
     engine_->newGame();
 }
 
 void Uci::positionCommand(std::istream& stream) {
+    stopSearch();
+
     auto type = std::string();
     stream >> type;
 
@@ -212,6 +266,7 @@ void Uci::positionCommand(std::istream& stream) {
     }
 
     board_ = newBoard.value();
+    auto history = std::vector<Zobrist::Key>();
 
     auto moves = std::string();
     stream >> moves;
@@ -232,10 +287,13 @@ void Uci::positionCommand(std::istream& stream) {
                 return;
             }
 
+            history.push_back(board_.hash());
             board_.makeMove(optMove.value());
         }
     }
 
+    engine_->setGameHistory(history);
+
     log_ << board_ << std::endl;
 }
 
@@ -249,9 +307,15 @@ static std::optional<T> readValue(std::istream& stream) {
 }
 
 TimeInfo::Optional Uci::readTimeInfo(std::istream& stream) {
-    std::optional<unsigned> wtime, winc, btime, binc, movestogo;
+    std::optional<unsigned> wtime, winc, btime, binc, movestogo, depth;
+    auto infinite = false;
 
     for (std::string command; stream >> command;) {
+        if (command == "infinite") {
+            infinite = true;
+            continue;
+        }
+
         auto value = readValue<unsigned>(stream);
 
         if (command == "wtime") {
@@ -264,13 +328,17 @@ TimeInfo::Optional Uci::readTimeInfo(std::istream& stream) {
             binc = value;
         } else if (command == "movestogo") {
             movestogo = value;
-        } else if (command == "infinite") {
-            error("go infinite not supported");
-            return std::nullopt;
+        } else if (command == "depth") {
+            depth = value;
         }
     }
 
-    if (wtime.has_value() && btime.has_value()) {
+    if (infinite || depth.has_value()) {
+        TimeInfo timeInfo = {};
+        timeInfo.infinite = infinite;
+        timeInfo.depth = depth;
+        return timeInfo;
+    } else if (wtime.has_value() && btime.has_value()) {
         PlayerTimeInfo whiteTime, blackTime;
         whiteTime.timeLeft = std::chrono::milliseconds(wtime.value());
         whiteTime.increment = std::chrono::milliseconds(winc.value_or(0));
@@ -288,31 +356,110 @@ TimeInfo::Optional Uci::readTimeInfo(std::istream& stream) {
 }
 
 void Uci::goCommand(std::istream& stream) {
+    stopSearch();
+
+    //Non-standard extension: "go perft <depth>" reports the move counts of the current position
+    auto arguments = stream.tellg();
+    if (auto mode = std::string(); stream >> mode && mode == "perft") {
+        perftCommand(stream);
+        return;
+    }
+    stream.clear();
+    stream.seekg(arguments);
+
     auto timeInfo = readTimeInfo(stream);
-    auto pv = engine_->pv(board_, timeInfo);
+
+    infiniteSearch_ = timeInfo.has_value() && timeInfo->infinite;
+    stopRequested_ = false;
+    engine_->clearStop();
+    searchThread_ = std::thread(&Uci::search, this, board_, timeInfo);
+}
+
+void Uci::stopCommand(std::istream&) {
+    stopSearch();
+}
+
+void Uci::search(Board board, TimeInfo::Optional timeInfo) {
+    auto pv = engine_->pv(board, timeInfo);
+
+    // After "go infinite" the best move may only be sent once the GUI says
+    // stop, even when the engine has nothing left to search.
+    if (timeInfo.has_value() && timeInfo->infinite) {
+        auto lock = std::unique_lock(searchMutex_);
+        stopCondition_.wait(lock, [this] { return stopRequested_; });
+    }
 
     if (pv.length() == 0) {
         error("Engine returned no PV");
         return;
     }
 
-    log_ << "PV: " << pv << std::endl;
+    {
+        auto lock = std::lock_guard(outputMutex_);
+        log_ << "PV: " << pv << std::endl;
+    }
     sendPvInfo(pv);
 
     auto bestMove = *pv.begin();
     board_.makeMove(bestMove);
-    log_ << board_ << std::endl;
+    {
+        auto lock = std::lock_guard(outputMutex_);
+        log_ << board_ << std::endl;
+    }
 
     auto bestMoveCmd = std::stringstream();
     bestMoveCmd << "bestmove " << bestMove;
     sendCommand(bestMoveCmd.str());
 }
 
+void Uci::stopSearch() {
+    if (!searchThread_.joinable()) {
+        return;
+    }
+
+    {
+        auto lock = std::lock_guard(searchMutex_);
+        stopRequested_ = true;
+    }
+    stopCondition_.notify_all();
+
+    engine_->stop();
+    searchThread_.join();
+}
+
+void Uci::waitForSearch() {
+    // Nothing else would end an infinite search.
+    if (infiniteSearch_) {
+        stopSearch();
+    } else if (searchThread_.joinable()) {
+        searchThread_.join();
+    }
+}
+
+void Uci::perftCommand(std::istream& stream) {
+    auto depth = readValue<unsigned>(stream);
+
+    if (!depth.has_value()) {
+        error("Illegal go perft: missing depth");
+        return;
+    }
+
+    auto report = std::stringstream();
+    Perft::report(board_, depth.value(), report);
+
+    for (std::string line; std::getline(report, line);) {
+        sendCommand(line);
+    }
+}
+
 void Uci::quitCommand(std::istream&) {
+    stopSearch();
     std::exit(EXIT_SUCCESS);
 }
 
 void Uci::setoptionCommand(std::istream& stream) {
+    stopSearch();
+
     std::string nameCommand;
     stream >> nameCommand;
 
@@ -349,7 +496,13 @@ void Uci::setoptionCommand(std::istream& stream) {
 
 void Uci::sendPvInfo(const PrincipalVariation& pv) {
     auto stream = std::stringstream();
-    stream << "info score ";
+    stream << "info ";
+
+    if (auto searchInfo = engine_->searchInfo(); searchInfo.has_value()) {
+        stream << "depth " << searchInfo->depth << " nodes " << searchInfo->nodes << ' ';
+    }
+
+    stream << "score ";
 
     auto score = pv.score();
 
@@ -379,11 +532,13 @@ void Uci::sendOptions() {
 }
 
 void Uci::sendCommand(const std::string& command) {
+    auto lock = std::lock_guard(outputMutex_);
     log_ << "< " << command << std::endl;
     cmdOut_ << command << std::endl;
 }
 
 void Uci::error(const std::string& msg) {
+    auto lock = std::lock_guard(outputMutex_);
     log_ << "UCI error: " << msg << std::endl;
     std::exit(EXIT_FAILURE);
 }
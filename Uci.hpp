@@ -8,6 +8,9 @@
 #include <iosfwd>
 #include <memory>
 #include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 class Engine;
 class PrincipalVariation;
@@ -32,9 +35,14 @@ private:
     void ucinewgameCommand(std::istream& stream);
     void positionCommand(std::istream& stream);
     void goCommand(std::istream& stream);
+    void stopCommand(std::istream& stream);
+    void perftCommand(std::istream& stream);
     void quitCommand(std::istream& stream);
     void setoptionCommand(std::istream& stream);
     TimeInfo::Optional readTimeInfo(std::istream& stream);
+    void search(Board board, TimeInfo::Optional timeInfo);
+    void stopSearch();
+    void waitForSearch();
     void sendPvInfo(const PrincipalVariation& pv);
     void sendOptions();
     void sendCommand(const std::string& line);
@@ -46,6 +54,17 @@ private:
     std::ostream& cmdOut_;
     std::ostream& log_;
     std::map<std::string, std::unique_ptr<UciOptionBase>> options_;
+
+    // The search runs on its own thread so commands are still read while
+    // thinking.
+    std::thread searchThread_;
+    bool infiniteSearch_ = false;
+    bool stopRequested_ = false;
+    std::mutex searchMutex_;
+    std::condition_variable stopCondition_;
+
+    // Both threads send commands and write to the log.
+    std::mutex outputMutex_;
 };
 
 #endif
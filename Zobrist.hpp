@@ -0,0 +1,68 @@
+#ifndef CHESS_ENGINE_ZOBRIST_HPP
+#define CHESS_ENGINE_ZOBRIST_HPP
+
+#include "Piece.hpp"
+#include "Square.hpp"
+#include "CastlingRights.hpp"
+
+#include <cstdint>
+
+//Random keys XORed together to identify a position, so a move only has to XOR the keys of what it changes
+namespace Zobrist {
+
+    using Key = std::uint64_t;
+
+    struct Keys {
+        Key pieces[2][6][64];
+        Key castling[16];
+        Key en_passant_file[8];
+        Key black_to_move;
+    };
+
+    //splitmix64, good enough statistical quality for hashing and usable at compile time
+    constexpr Key nextRandom(Key& state) {
+        Key z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    inline constexpr Keys keys = [] {
+        Keys generated{};
+        Key state = 0x5EED5EED5EED5EEDULL;
+        for(auto& color_keys : generated.pieces) {
+            for(auto& type_keys : color_keys) {
+                for(auto& key : type_keys) key = nextRandom(state);
+            }
+        }
+        //Every combination of rights gets the XOR of its single rights, so rights can be toggled one by one
+        Key single_rights[4];
+        for(auto& key : single_rights) key = nextRandom(state);
+        for(unsigned rights = 0; rights < 16; rights++) {
+            for(unsigned bit = 0; bit < 4; bit++) {
+                if(rights & (1u << bit)) generated.castling[rights] ^= single_rights[bit];
+            }
+        }
+        for(auto& key : generated.en_passant_file) key = nextRandom(state);
+        generated.black_to_move = nextRandom(state);
+        return generated;
+    }();
+
+    constexpr Key piece(PieceColor color, PieceType type, Square::Index index) {
+        return keys.pieces[static_cast<unsigned>(color)][static_cast<unsigned>(type)][index];
+    }
+
+    constexpr Key castling(CastlingRights rights) {
+        return keys.castling[static_cast<unsigned>(rights)];
+    }
+
+    constexpr Key enPassant(Square::Index index) {
+        return keys.en_passant_file[index % 8];
+    }
+
+    constexpr Key turn(PieceColor color) {
+        return color == PieceColor::Black ? keys.black_to_move : 0;
+    }
+}
+
+#endif